@@ -0,0 +1,237 @@
+/**************************************************************************/
+/*  baggage.cpp                                                           */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "baggage.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_set>
+
+using namespace godot;
+
+const char *Baggage::HEADER = "baggage";
+
+static bool is_baggage_octet(unsigned char p_char) {
+	// baggage-octet from the W3C baggage specification; everything else,
+	// including '%' itself, is percent-encoded.
+	return p_char == 0x21 || (p_char >= 0x23 && p_char <= 0x2B) || (p_char >= 0x2D && p_char <= 0x3A) ||
+			(p_char >= 0x3C && p_char <= 0x5B && p_char != 0x25) || (p_char >= 0x5D && p_char <= 0x7E);
+}
+
+static int hex_value(char p_char) {
+	if (p_char >= '0' && p_char <= '9') {
+		return p_char - '0';
+	}
+	if (p_char >= 'a' && p_char <= 'f') {
+		return p_char - 'a' + 10;
+	}
+	if (p_char >= 'A' && p_char <= 'F') {
+		return p_char - 'A' + 10;
+	}
+	return -1;
+}
+
+static void append_percent_encoded(std::string &r_header, const std::string &p_value) {
+	static const char HEX_DIGITS[] = "0123456789ABCDEF";
+	for (unsigned char c : p_value) {
+		if (is_baggage_octet(c)) {
+			r_header += (char)c;
+		} else {
+			r_header += '%';
+			r_header += HEX_DIGITS[c >> 4];
+			r_header += HEX_DIGITS[c & 0xf];
+		}
+	}
+}
+
+static std::string percent_decode(const char *p_value, size_t p_length) {
+	std::string decoded;
+	decoded.reserve(p_length);
+	for (size_t i = 0; i < p_length; i++) {
+		if (p_value[i] == '%' && i + 2 < p_length && hex_value(p_value[i + 1]) >= 0 && hex_value(p_value[i + 2]) >= 0) {
+			decoded += (char)(hex_value(p_value[i + 1]) << 4 | hex_value(p_value[i + 2]));
+			i += 2;
+		} else {
+			decoded += p_value[i];
+		}
+	}
+	return decoded;
+}
+
+static void trim(const char *&r_value, size_t &r_length) {
+	while (r_length > 0 && (*r_value == ' ' || *r_value == '\t')) {
+		r_value++;
+		r_length--;
+	}
+	while (r_length > 0 && (r_value[r_length - 1] == ' ' || r_value[r_length - 1] == '\t')) {
+		r_length--;
+	}
+}
+
+Baggage Baggage::push(Entry p_entry, bool p_removed) const {
+	std::shared_ptr<Node> node = std::make_shared<Node>();
+	node->entry = std::move(p_entry);
+	node->removed = p_removed;
+	node->next = head;
+	node->depth = head ? head->depth + 1 : 1;
+
+	Baggage result;
+	result.head = node;
+	if (node->depth > 2 * (size_t)MAX_ENTRIES) {
+		// Too many shadowed or removed nodes: rebuild from the live entries.
+		std::vector<Entry> entries;
+		result.get_all(entries);
+		Baggage compacted;
+		for (size_t i = entries.size(); i > 0; i--) {
+			std::shared_ptr<Node> live = std::make_shared<Node>();
+			live->entry = std::move(entries[i - 1]);
+			live->next = compacted.head;
+			live->depth = compacted.head ? compacted.head->depth + 1 : 1;
+			compacted.head = live;
+		}
+		return compacted;
+	}
+	return result;
+}
+
+bool Baggage::get_value(const std::string &p_name, std::string &r_value) const {
+	for (const Node *node = head.get(); node; node = node->next.get()) {
+		if (node->entry.name == p_name) {
+			if (node->removed) {
+				return false;
+			}
+			r_value = node->entry.value;
+			return true;
+		}
+	}
+	return false;
+}
+
+void Baggage::get_all(std::vector<Entry> &r_entries) const {
+	std::unordered_set<std::string> seen;
+	for (const Node *node = head.get(); node; node = node->next.get()) {
+		if (seen.insert(node->entry.name).second && !node->removed) {
+			r_entries.push_back(node->entry);
+		}
+	}
+}
+
+bool Baggage::is_empty() const {
+	std::unordered_set<std::string> seen;
+	for (const Node *node = head.get(); node; node = node->next.get()) {
+		if (seen.insert(node->entry.name).second && !node->removed) {
+			return false;
+		}
+	}
+	return true;
+}
+
+Baggage Baggage::set_value(const std::string &p_name, const std::string &p_value, const std::string &p_metadata) const {
+	if (p_name.empty()) {
+		return *this;
+	}
+	return push(Entry{ p_name, p_value, p_metadata }, false);
+}
+
+Baggage Baggage::remove_value(const std::string &p_name) const {
+	std::string value;
+	if (!get_value(p_name, value)) {
+		return *this;
+	}
+	return push(Entry{ p_name, std::string(), std::string() }, true);
+}
+
+std::string Baggage::to_header() const {
+	std::vector<Entry> entries;
+	get_all(entries);
+
+	std::string header;
+	std::string member;
+	int count = 0;
+	// Oldest first, so the header order is stable as values are added.
+	for (size_t i = entries.size(); i > 0 && count < MAX_ENTRIES; i--) {
+		const Entry &entry = entries[i - 1];
+		member.clear();
+		member += entry.name;
+		member += '=';
+		append_percent_encoded(member, entry.value);
+		if (!entry.metadata.empty()) {
+			member += ';';
+			member += entry.metadata;
+		}
+		size_t length = header.size() + (header.empty() ? 0 : 1) + member.size();
+		if (length > MAX_HEADER_LENGTH) {
+			continue;
+		}
+		if (!header.empty()) {
+			header += ',';
+		}
+		header += member;
+		count++;
+	}
+	return header;
+}
+
+Baggage Baggage::from_header(const char *p_value, size_t p_length) {
+	Baggage baggage;
+	size_t start = 0;
+	int count = 0;
+	while (start < p_length && count < MAX_ENTRIES) {
+		const char *comma = (const char *)memchr(p_value + start, ',', p_length - start);
+		size_t end = comma ? (size_t)(comma - p_value) : p_length;
+
+		const char *member = p_value + start;
+		size_t member_length = end - start;
+		const char *semicolon = (const char *)memchr(member, ';', member_length);
+		size_t pair_length = semicolon ? (size_t)(semicolon - member) : member_length;
+		const char *equals = (const char *)memchr(member, '=', pair_length);
+		if (equals) {
+			const char *name = member;
+			size_t name_length = equals - member;
+			const char *value = equals + 1;
+			size_t value_length = pair_length - name_length - 1;
+			trim(name, name_length);
+			trim(value, value_length);
+			std::string metadata;
+			if (semicolon) {
+				const char *properties = semicolon + 1;
+				size_t properties_length = member_length - pair_length - 1;
+				trim(properties, properties_length);
+				metadata.assign(properties, properties_length);
+			}
+			if (name_length > 0) {
+				baggage = baggage.set_value(std::string(name, name_length), percent_decode(value, value_length), metadata);
+				count++;
+			}
+		}
+		start = end + 1;
+	}
+	return baggage;
+}
@@ -0,0 +1,88 @@
+/**************************************************************************/
+/*  baggage.h                                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef BAGGAGE_H
+#define BAGGAGE_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace godot {
+
+// Immutable name/value pairs propagated alongside the trace context, as in
+// the OpenTelemetry Baggage API. set_value() and remove_value() return a new
+// Baggage that shares every existing entry with the old one: each change
+// prepends a single node to a persistent list, so deriving a child's
+// baggage never copies the parent's map. Chains are compacted once they
+// grow well past the number of live entries.
+class Baggage {
+public:
+	// W3C baggage limits for one header.
+	static const int MAX_ENTRIES = 64;
+	static const size_t MAX_HEADER_LENGTH = 8192;
+	static const char *HEADER;
+
+	struct Entry {
+		std::string name;
+		std::string value;
+		std::string metadata;
+	};
+
+private:
+	struct Node {
+		Entry entry;
+		bool removed = false;
+		size_t depth = 1;
+		std::shared_ptr<const Node> next;
+	};
+
+	std::shared_ptr<const Node> head;
+
+	Baggage push(Entry p_entry, bool p_removed) const;
+
+public:
+	bool get_value(const std::string &p_name, std::string &r_value) const;
+	// Live entries, most recently set first.
+	void get_all(std::vector<Entry> &r_entries) const;
+	bool is_empty() const;
+	Baggage set_value(const std::string &p_name, const std::string &p_value, const std::string &p_metadata = std::string()) const;
+	Baggage remove_value(const std::string &p_name) const;
+
+	// W3C `baggage` header: `name=value;metadata,...` with percent-encoded
+	// values, truncated at whole entries to the header limits.
+	std::string to_header() const;
+	static Baggage from_header(const char *p_value, size_t p_length);
+};
+
+} // namespace godot
+
+#endif // BAGGAGE_H
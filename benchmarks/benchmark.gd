@@ -0,0 +1,132 @@
+extends SceneTree
+
+# Headless microbenchmarks of the OpenTelemetry hot paths.
+#
+#   godot --headless --path benchmarks --script res://benchmark.gd -- [--iterations=N] [--output=FILE]
+#
+# Prints one JSON document with ns/op and bytes/op per benchmark, and writes
+# it to FILE when given. bytes/op is the growth of Godot's allocator
+# (OS.get_static_memory_usage) per operation; DuckDB allocates outside of
+# it, so buffer growth is not included.
+
+const DEFAULT_ITERATIONS := 10000
+const FLUSH_BATCH_SIZES: Array[int] = [1, 10, 100, 1000]
+const WARMUP_FRACTION := 10
+
+var otel: OpenTelemetry
+var iterations := DEFAULT_ITERATIONS
+var output_path := ""
+var results: Array[Dictionary] = []
+
+
+func _initialize() -> void:
+	for argument in OS.get_cmdline_user_args():
+		if argument.begins_with("--iterations="):
+			iterations = maxi(argument.get_slice("=", 1).to_int(), 1)
+		elif argument.begins_with("--output="):
+			output_path = argument.get_slice("=", 1)
+
+	otel = OpenTelemetry.new()
+	# No collector runs here, so flush_all measures reading and encoding the
+	# buffer and a refused connection. export_benchmark.gd measures exports.
+	otel.init_tracer_provider("benchmark", "http://127.0.0.1:9", {})
+	# Keep flushes out of the per-operation numbers.
+	otel.set_batch_size(1 << 30)
+	otel.set_flush_interval(1 << 30)
+
+	run_benchmarks()
+	otel.shutdown()
+	report()
+	quit()
+
+
+func run_benchmarks() -> void:
+	bench("generate_uuid_v7", func(_i: int) -> void:
+		otel.generate_uuid_v7())
+
+	# An Array, not a PackedStringArray: lambdas capture packed arrays by value.
+	var spans := []
+	spans.resize(iterations)
+	bench("start_span", func(i: int) -> void:
+		spans[i] = otel.start_span("benchmark"))
+	var attributes := { "player.id": 42, "zone": "lobby", "latency_ms": 12.5 }
+	bench("set_attributes", func(i: int) -> void:
+		otel.set_attributes(spans[i], attributes))
+	bench("add_event", func(i: int) -> void:
+		otel.add_event(spans[i], "checkpoint"))
+	bench("end_span", func(i: int) -> void:
+		otel.end_span(spans[i]))
+	otel.flush_all()
+
+	var metric_attributes := { "zone": "lobby" }
+	bench("record_metric", func(i: int) -> void:
+		otel.record_metric("benchmark.latency", float(i % 100), "ms", OpenTelemetry.METRIC_TYPE_HISTOGRAM, metric_attributes))
+
+	bench("log_message", func(_i: int) -> void:
+		otel.log_message("INFO", "benchmark message", metric_attributes))
+	otel.flush_all()
+	otel.set_min_log_severity(OpenTelemetry.LOG_SEVERITY_WARN)
+	bench("log_message_filtered", func(_i: int) -> void:
+		otel.log_message("INFO", "benchmark message", metric_attributes))
+	otel.set_min_log_severity(OpenTelemetry.LOG_SEVERITY_UNSPECIFIED)
+
+	# flush_all cost grows with what is buffered, so it is measured per
+	# batch: fill the buffer, then time one flush.
+	for batch_size in FLUSH_BATCH_SIZES:
+		var runs := maxi(iterations / batch_size / 10, 3)
+		var total_usec := 0
+		var total_bytes := 0
+		for run in runs:
+			for i in batch_size:
+				otel.end_span(otel.start_span("batch"))
+				otel.log_message("INFO", "batch message", {})
+			var memory := OS.get_static_memory_usage()
+			var start := Time.get_ticks_usec()
+			otel.flush_all()
+			total_usec += Time.get_ticks_usec() - start
+			total_bytes += OS.get_static_memory_usage() - memory
+		add_result("flush_all", batch_size, runs, total_usec * 1000.0 / runs, float(total_bytes) / runs)
+
+
+func bench(name: String, operation: Callable) -> void:
+	# The warm-up gets its own slice of indices, so span operations still
+	# find a distinct span for every measured call.
+	var warmup := iterations / WARMUP_FRACTION
+	for i in warmup:
+		operation.call(i)
+	var memory := OS.get_static_memory_usage()
+	var start := Time.get_ticks_usec()
+	for i in range(warmup, iterations):
+		operation.call(i)
+	var elapsed_usec := Time.get_ticks_usec() - start
+	var bytes := OS.get_static_memory_usage() - memory
+	var count := iterations - warmup
+	add_result(name, 1, count, elapsed_usec * 1000.0 / count, float(bytes) / count)
+
+
+func add_result(name: String, batch_size: int, count: int, ns_per_op: float, bytes_per_op: float) -> void:
+	results.append({
+		"name": name,
+		"batch_size": batch_size,
+		"iterations": count,
+		"ns_per_op": snappedf(ns_per_op, 0.1),
+		"bytes_per_op": snappedf(bytes_per_op, 0.1),
+	})
+
+
+func report() -> void:
+	var document := {
+		"godot_version": Engine.get_version_info().string,
+		"debug_build": OS.is_debug_build(),
+		"processor": OS.get_processor_name(),
+		"timestamp": Time.get_datetime_string_from_system(true),
+		"results": results,
+	}
+	var json := JSON.stringify(document, "\t")
+	print(json)
+	if not output_path.is_empty():
+		var file := FileAccess.open(output_path, FileAccess.WRITE)
+		if file:
+			file.store_string(json + "\n")
+		else:
+			push_error("Cannot write %s" % output_path)
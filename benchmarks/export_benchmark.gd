@@ -0,0 +1,161 @@
+extends SceneTree
+
+# Export throughput and latency against mock_collector.gd.
+#
+#   godot --headless --path benchmarks --script res://export_benchmark.gd -- [--spans=N] [--port=N] [--output=FILE] [collector options]
+#
+# Starts the mock collector as a second process, exports spans to it in
+# batches of 10, 100 and 1000, and reports per batch size: spans/sec
+# exported, bytes/span on the wire, and the p50/p99 time from a span's end
+# to its arrival at the collector. Options the benchmark does not know,
+# such as --latency-ms or --error-rate, are passed on to the collector.
+# Exits with an error when the collector found payloads that are not valid
+# OTLP/JSON.
+
+const DEFAULT_SPANS := 20000
+const DEFAULT_PORT := 4319
+const BATCH_SIZES: Array[int] = [10, 100, 1000]
+const STARTUP_TIMEOUT_MSEC := 10000
+
+var span_count := DEFAULT_SPANS
+var port := DEFAULT_PORT
+var output_path := ""
+var collector_args := PackedStringArray()
+var collector_pid := -1
+var results: Array[Dictionary] = []
+
+
+func _initialize() -> void:
+	for argument in OS.get_cmdline_user_args():
+		if argument.begins_with("--spans="):
+			span_count = maxi(argument.get_slice("=", 1).to_int(), 1)
+		elif argument.begins_with("--port="):
+			port = argument.get_slice("=", 1).to_int()
+		elif argument.begins_with("--output="):
+			output_path = argument.get_slice("=", 1)
+		else:
+			collector_args.append(argument)
+
+	if start_collector():
+		for batch_size in BATCH_SIZES:
+			run_batch(batch_size)
+		collector_request(HTTPClient.METHOD_POST, "/shutdown")
+	if collector_pid > 0:
+		OS.kill(collector_pid)
+	report()
+	var schema_errors := 0
+	for result in results:
+		schema_errors += result.schema_errors
+	if schema_errors > 0:
+		push_error("The collector reported %d schema errors" % schema_errors)
+	quit(0 if not results.is_empty() and schema_errors == 0 else 1)
+
+
+func start_collector() -> bool:
+	var arguments := PackedStringArray(["--headless", "--path", ProjectSettings.globalize_path("res://"), "--script", "res://mock_collector.gd", "--", "--port=%d" % port])
+	arguments.append_array(collector_args)
+	collector_pid = OS.create_process(OS.get_executable_path(), arguments)
+	if collector_pid < 0:
+		push_error("Cannot start the mock collector")
+		return false
+	var deadline := Time.get_ticks_msec() + STARTUP_TIMEOUT_MSEC
+	while Time.get_ticks_msec() < deadline:
+		if not collector_request(HTTPClient.METHOD_POST, "/reset").is_empty():
+			return true
+		OS.delay_msec(100)
+	push_error("The mock collector did not start on port %d" % port)
+	return false
+
+
+func run_batch(batch_size: int) -> void:
+	collector_request(HTTPClient.METHOD_POST, "/reset")
+	var otel := OpenTelemetry.new()
+	otel.init_tracer_provider("export-benchmark", "http://127.0.0.1:%d" % port, {})
+	otel.set_batch_size(1 << 30)
+	otel.set_flush_interval(1 << 30)
+	var attributes := { "player.id": 42, "zone": "lobby" }
+
+	var flush_usec := 0
+	var start := Time.get_ticks_usec()
+	for i in span_count:
+		var span := otel.start_span("export")
+		otel.set_attributes(span, attributes)
+		otel.end_span(span)
+		if (i + 1) % batch_size == 0:
+			var flush_start := Time.get_ticks_usec()
+			otel.flush_all()
+			flush_usec += Time.get_ticks_usec() - flush_start
+	var flush_start := Time.get_ticks_usec()
+	otel.flush_all()
+	flush_usec += Time.get_ticks_usec() - flush_start
+	# Exports run on the SDK's export thread; shutdown waits for them.
+	otel.shutdown()
+	var elapsed_usec := Time.get_ticks_usec() - start
+
+	var stats := collector_request(HTTPClient.METHOD_GET, "/stats")
+	var traces: Dictionary = stats.get("traces", {})
+	var received: int = traces.get("items", 0)
+	results.append({
+		"name": "export_spans",
+		"batch_size": batch_size,
+		"spans": span_count,
+		"spans_received": received,
+		"spans_per_sec": snappedf(received / (elapsed_usec / 1000000.0), 0.1),
+		"flush_ns_per_span": snappedf(flush_usec * 1000.0 / span_count, 0.1),
+		"bytes_per_span": snappedf(float(traces.get("bytes", 0)) / maxi(received, 1), 0.1),
+		"requests": traces.get("requests", 0),
+		"schema_errors": traces.get("schema_errors", 0),
+		"injected_errors": traces.get("injected_errors", 0),
+		"rejected": traces.get("rejected", 0),
+		"latency_p50_usec": stats.get("span_latency_p50_usec", 0.0),
+		"latency_p99_usec": stats.get("span_latency_p99_usec", 0.0),
+	})
+
+
+# Blocking request to the collector's control endpoints. Returns the parsed
+# JSON body, or an empty Dictionary on failure.
+func collector_request(method: HTTPClient.Method, path: String) -> Dictionary:
+	var client := HTTPClient.new()
+	if client.connect_to_host("127.0.0.1", port) != OK:
+		return {}
+	var deadline := Time.get_ticks_msec() + 5000
+	while client.get_status() in [HTTPClient.STATUS_RESOLVING, HTTPClient.STATUS_CONNECTING]:
+		client.poll()
+		if Time.get_ticks_msec() > deadline:
+			return {}
+		OS.delay_msec(1)
+	if client.get_status() != HTTPClient.STATUS_CONNECTED or client.request(method, path, [], "") != OK:
+		return {}
+	while client.get_status() == HTTPClient.STATUS_REQUESTING:
+		client.poll()
+		if Time.get_ticks_msec() > deadline:
+			return {}
+		OS.delay_msec(1)
+	var body := PackedByteArray()
+	while client.get_status() == HTTPClient.STATUS_BODY:
+		client.poll()
+		body.append_array(client.read_response_body_chunk())
+		if Time.get_ticks_msec() > deadline:
+			break
+	client.close()
+	var parsed = JSON.parse_string(body.get_string_from_utf8())
+	return parsed if typeof(parsed) == TYPE_DICTIONARY else {}
+
+
+func report() -> void:
+	var document := {
+		"godot_version": Engine.get_version_info().string,
+		"debug_build": OS.is_debug_build(),
+		"processor": OS.get_processor_name(),
+		"timestamp": Time.get_datetime_string_from_system(true),
+		"collector_options": collector_args,
+		"results": results,
+	}
+	var json := JSON.stringify(document, "\t")
+	print(json)
+	if not output_path.is_empty():
+		var file := FileAccess.open(output_path, FileAccess.WRITE)
+		if file:
+			file.store_string(json + "\n")
+		else:
+			push_error("Cannot write %s" % output_path)
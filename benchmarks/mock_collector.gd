@@ -0,0 +1,377 @@
+extends SceneTree
+
+# Local stand-in for an OTLP/HTTP collector, used by export_benchmark.gd.
+#
+#   godot --headless --path benchmarks --script res://mock_collector.gd -- [options]
+#
+#   --port=N                    Port to listen on (default 4318).
+#   --latency-ms=N              Delay every response by N ms.
+#   --error-rate=F              Answer this fraction of exports with --error-status.
+#   --error-status=N            429 or 503 (default 503), with Retry-After.
+#   --partial-success-rate=F    Answer this fraction with a partial_success
+#                               rejecting half of the items.
+#   --strict                    Answer 400 to payloads that fail validation.
+#
+# POST /v1/traces, /v1/metrics and /v1/logs accept OTLP/JSON and OTLP/protobuf.
+# JSON payloads are checked against the OTLP/JSON field names and formats;
+# protobuf payloads are walked at the wire format level to count items.
+# GET /stats returns the counters as JSON, POST /reset clears them and
+# POST /shutdown stops the collector.
+
+const SIGNALS := {
+	"/v1/traces": ["traces", "resourceSpans", "scopeSpans", "spans", "rejectedSpans"],
+	"/v1/metrics": ["metrics", "resourceMetrics", "scopeMetrics", "metrics", "rejectedDataPoints"],
+	"/v1/logs": ["logs", "resourceLogs", "scopeLogs", "logRecords", "rejectedLogRecords"],
+}
+const METRIC_DATA_FIELDS: Array[String] = ["gauge", "sum", "histogram", "exponentialHistogram", "summary"]
+const MAX_LATENCY_SAMPLES := 100000
+const MAX_REQUEST_SIZE := 64 * 1024 * 1024
+
+var port := 4318
+var latency_msec := 0
+var error_rate := 0.0
+var error_status := 503
+var partial_success_rate := 0.0
+var strict := false
+
+var server := TCPServer.new()
+var clients: Array[Dictionary] = []
+var stats := {}
+# Microseconds from a span's end time to its arrival here.
+var span_latencies := PackedFloat64Array()
+
+
+func _initialize() -> void:
+	for argument in OS.get_cmdline_user_args():
+		var value := argument.get_slice("=", 1)
+		if argument.begins_with("--port="):
+			port = value.to_int()
+		elif argument.begins_with("--latency-ms="):
+			latency_msec = value.to_int()
+		elif argument.begins_with("--error-rate="):
+			error_rate = value.to_float()
+		elif argument.begins_with("--error-status="):
+			error_status = value.to_int()
+		elif argument.begins_with("--partial-success-rate="):
+			partial_success_rate = value.to_float()
+		elif argument == "--strict":
+			strict = true
+	reset_stats()
+	var err := server.listen(port, "127.0.0.1")
+	if err != OK:
+		push_error("Cannot listen on port %d: %s" % [port, error_string(err)])
+		quit(1)
+		return
+	print("Mock OTLP collector listening on 127.0.0.1:%d" % port)
+
+
+func _process(_delta: float) -> bool:
+	while server.is_connection_available():
+		clients.append({ "peer": server.take_connection(), "buffer": PackedByteArray(), "pending": [] })
+	for client in clients.duplicate():
+		poll_client(client)
+	return false
+
+
+func reset_stats() -> void:
+	stats = {}
+	for path in SIGNALS:
+		stats[SIGNALS[path][0]] = {
+			"requests": 0,
+			"protobuf_requests": 0,
+			"items": 0,
+			"bytes": 0,
+			"schema_errors": 0,
+			"injected_errors": 0,
+			"rejected": 0,
+		}
+	span_latencies.clear()
+
+
+func poll_client(client: Dictionary) -> void:
+	var peer: StreamPeerTCP = client.peer
+	peer.poll()
+	if peer.get_status() != StreamPeerTCP.STATUS_CONNECTED:
+		clients.erase(client)
+		return
+	var available := peer.get_available_bytes()
+	if available > 0:
+		var result := peer.get_partial_data(available)
+		if result[0] == OK:
+			# Packed arrays are values; assign so the Dictionary sees the change.
+			var buffer: PackedByteArray = client.buffer
+			buffer.append_array(result[1])
+			client.buffer = buffer
+	# Keep-alive: parse every complete request in the buffer.
+	while true:
+		var request := take_request(client)
+		if request.is_empty():
+			break
+		var response := handle_request(request)
+		client.pending.append({ "due": Time.get_ticks_msec() + latency_msec, "data": response })
+	while not client.pending.is_empty() and client.pending[0].due <= Time.get_ticks_msec():
+		peer.put_data(client.pending.pop_front().data)
+	if client.buffer.size() > MAX_REQUEST_SIZE:
+		peer.disconnect_from_host()
+		clients.erase(client)
+
+
+func take_request(client: Dictionary) -> Dictionary:
+	var buffer: PackedByteArray = client.buffer
+	var header_end := -1
+	for i in range(buffer.size() - 3):
+		if buffer[i] == 13 and buffer[i + 1] == 10 and buffer[i + 2] == 13 and buffer[i + 3] == 10:
+			header_end = i
+			break
+	if header_end < 0:
+		return {}
+	var lines := buffer.slice(0, header_end).get_string_from_utf8().split("\r\n")
+	var request_line := lines[0].split(" ")
+	var headers := {}
+	for i in range(1, lines.size()):
+		var colon := lines[i].find(":")
+		if colon > 0:
+			headers[lines[i].substr(0, colon).strip_edges().to_lower()] = lines[i].substr(colon + 1).strip_edges()
+	var body_start := header_end + 4
+	var length := int(headers.get("content-length", "0"))
+	if buffer.size() < body_start + length:
+		return {}
+	client.buffer = buffer.slice(body_start + length)
+	return {
+		"method": request_line[0] if request_line.size() > 0 else "",
+		"path": request_line[1].get_slice("?", 0) if request_line.size() > 1 else "",
+		"headers": headers,
+		"body": buffer.slice(body_start, body_start + length),
+	}
+
+
+func handle_request(request: Dictionary) -> PackedByteArray:
+	var path: String = request.path
+	if request.method == "GET" and path == "/stats":
+		return respond(200, JSON.stringify(get_stats()))
+	if request.method == "POST" and path == "/reset":
+		reset_stats()
+		return respond(200, "{}")
+	if request.method == "POST" and path == "/shutdown":
+		quit()
+		return respond(200, "{}")
+	if request.method != "POST" or not SIGNALS.has(path):
+		return respond(404, "{}")
+
+	var received_usec := Time.get_unix_time_from_system() * 1000000.0
+	var signal_stats: Dictionary = stats[SIGNALS[path][0]]
+	var body: PackedByteArray = request.body
+	signal_stats.requests += 1
+	signal_stats.bytes += body.size()
+
+	if error_rate > 0.0 and randf() < error_rate:
+		signal_stats.injected_errors += 1
+		return respond(error_status, JSON.stringify({ "code": 14, "message": "injected error" }), ["Retry-After: 1"])
+
+	var result: Dictionary
+	if String(request.headers.get("content-type", "")).begins_with("application/x-protobuf"):
+		signal_stats.protobuf_requests += 1
+		result = validate_protobuf(body)
+	else:
+		result = validate_json(path, body.get_string_from_utf8(), received_usec)
+	signal_stats.items += result.items
+	signal_stats.schema_errors += result.errors
+	if strict and result.errors > 0:
+		return respond(400, JSON.stringify({ "code": 3, "message": "%d schema errors" % result.errors }))
+
+	if partial_success_rate > 0.0 and randf() < partial_success_rate:
+		var rejected: int = result.items / 2
+		signal_stats.rejected += rejected
+		var partial_success := { SIGNALS[path][4]: str(rejected), "errorMessage": "injected partial success" }
+		return respond(200, JSON.stringify({ "partialSuccess": partial_success }))
+	return respond(200, "{}")
+
+
+func respond(status: int, body: String, extra_headers: Array[String] = []) -> PackedByteArray:
+	var reasons := { 200: "OK", 400: "Bad Request", 404: "Not Found", 429: "Too Many Requests", 503: "Service Unavailable" }
+	var data := body.to_utf8_buffer()
+	var head := "HTTP/1.1 %d %s\r\n" % [status, reasons.get(status, "Error")]
+	head += "Content-Type: application/json\r\n"
+	head += "Content-Length: %d\r\n" % data.size()
+	for header in extra_headers:
+		head += header + "\r\n"
+	head += "Connection: keep-alive\r\n\r\n"
+	var response := head.to_utf8_buffer()
+	response.append_array(data)
+	return response
+
+
+func validate_json(path: String, text: String, received_usec: float) -> Dictionary:
+	var result := { "items": 0, "errors": 0 }
+	var root = JSON.parse_string(text)
+	var keys: Array = SIGNALS[path]
+	if typeof(root) != TYPE_DICTIONARY or typeof(root.get(keys[1])) != TYPE_ARRAY:
+		result.errors += 1
+		return result
+	for resource in root[keys[1]]:
+		if typeof(resource) != TYPE_DICTIONARY or typeof(resource.get(keys[2], [])) != TYPE_ARRAY:
+			result.errors += 1
+			continue
+		if resource.has("resource") and typeof(resource.resource.get("attributes", [])) != TYPE_ARRAY:
+			result.errors += 1
+		for scope in resource.get(keys[2], []):
+			if typeof(scope) != TYPE_DICTIONARY or typeof(scope.get(keys[3], [])) != TYPE_ARRAY:
+				result.errors += 1
+				continue
+			for item in scope.get(keys[3], []):
+				result.items += 1
+				if typeof(item) != TYPE_DICTIONARY:
+					result.errors += 1
+					continue
+				match keys[0]:
+					"traces":
+						result.errors += validate_span(item, received_usec)
+					"metrics":
+						result.errors += validate_metric(item)
+					"logs":
+						result.errors += validate_log_record(item)
+	return result
+
+
+func validate_span(span: Dictionary, received_usec: float) -> int:
+	var errors := 0
+	if not is_hex_id(span.get("traceId"), 32) or not is_hex_id(span.get("spanId"), 16):
+		errors += 1
+	if span.has("parentSpanId") and span.parentSpanId != "" and not is_hex_id(span.parentSpanId, 16):
+		errors += 1
+	if typeof(span.get("name")) != TYPE_STRING:
+		errors += 1
+	if not is_uint64(span.get("startTimeUnixNano")) or not is_uint64(span.get("endTimeUnixNano")):
+		errors += 1
+	if span.has("attributes") and typeof(span.attributes) != TYPE_ARRAY:
+		errors += 1
+	var end_time = span.get("endTimeUnixNano")
+	if is_uint64(end_time) and span_latencies.size() < MAX_LATENCY_SAMPLES:
+		span_latencies.append(received_usec - float(end_time) / 1000.0)
+	return errors
+
+
+func validate_metric(metric: Dictionary) -> int:
+	var errors := 0
+	if typeof(metric.get("name")) != TYPE_STRING:
+		errors += 1
+	var data_fields := 0
+	for field in METRIC_DATA_FIELDS:
+		if metric.has(field):
+			data_fields += 1
+	if data_fields != 1:
+		errors += 1
+	return errors
+
+
+func validate_log_record(record: Dictionary) -> int:
+	var errors := 0
+	if record.has("severityNumber"):
+		var severity = record.severityNumber
+		if typeof(severity) != TYPE_INT and typeof(severity) != TYPE_FLOAT:
+			errors += 1
+		elif severity < 0 or severity > 24:
+			errors += 1
+	if not record.has("timeUnixNano") and not record.has("observedTimeUnixNano"):
+		errors += 1
+	for field in ["timeUnixNano", "observedTimeUnixNano"]:
+		if record.has(field) and not is_uint64(record[field]):
+			errors += 1
+	if record.has("traceId") and record.traceId != "" and not is_hex_id(record.traceId, 32):
+		errors += 1
+	if record.has("spanId") and record.spanId != "" and not is_hex_id(record.spanId, 16):
+		errors += 1
+	if record.has("attributes") and typeof(record.attributes) != TYPE_ARRAY:
+		errors += 1
+	return errors
+
+
+func is_hex_id(value: Variant, length: int) -> bool:
+	return typeof(value) == TYPE_STRING and value.length() == length and value.is_valid_hex_number() and value != "0".repeat(length)
+
+
+func is_uint64(value: Variant) -> bool:
+	# OTLP/JSON encodes 64 bit integers as decimal strings; numbers are accepted too.
+	if typeof(value) == TYPE_STRING:
+		return value.is_valid_int() and not value.begins_with("-")
+	return (typeof(value) == TYPE_INT or typeof(value) == TYPE_FLOAT) and value >= 0
+
+
+# Counts the items of an Export*ServiceRequest. All three signals nest them
+# the same way: field 1 (resource_*) > field 2 (scope_*) > field 2 (items).
+func validate_protobuf(body: PackedByteArray) -> Dictionary:
+	var result := { "items": 0, "errors": 0 }
+	var count := count_messages(body, 0, body.size(), [1, 2, 2], 0)
+	if count < 0:
+		result.errors += 1
+	else:
+		result.items = count
+	return result
+
+
+func count_messages(data: PackedByteArray, start: int, end: int, path: Array, depth: int) -> int:
+	var count := 0
+	var position := start
+	while position < end:
+		var key := read_varint(data, position, end)
+		if key.is_empty():
+			return -1
+		position = key.next
+		var wire_type: int = key.value & 7
+		var field: int = key.value >> 3
+		match wire_type:
+			0:
+				var value := read_varint(data, position, end)
+				if value.is_empty():
+					return -1
+				position = value.next
+			1:
+				position += 8
+			5:
+				position += 4
+			2:
+				var length := read_varint(data, position, end)
+				if length.is_empty() or length.next + length.value > end:
+					return -1
+				position = length.next
+				if field == path[depth]:
+					if depth == path.size() - 1:
+						count += 1
+					else:
+						var nested := count_messages(data, position, position + length.value, path, depth + 1)
+						if nested < 0:
+							return -1
+						count += nested
+				position += length.value
+			_:
+				return -1
+	return count if position == end else -1
+
+
+func read_varint(data: PackedByteArray, position: int, end: int) -> Dictionary:
+	var value := 0
+	var shift := 0
+	while position < end and shift < 64:
+		var byte := data[position]
+		position += 1
+		value |= (byte & 0x7f) << shift
+		if byte & 0x80 == 0:
+			return { "value": value, "next": position }
+		shift += 7
+	return {}
+
+
+func get_stats() -> Dictionary:
+	var latencies := span_latencies.duplicate()
+	latencies.sort()
+	var result := stats.duplicate(true)
+	result["span_latency_samples"] = latencies.size()
+	result["span_latency_p50_usec"] = percentile(latencies, 0.5)
+	result["span_latency_p99_usec"] = percentile(latencies, 0.99)
+	return result
+
+
+func percentile(sorted_values: PackedFloat64Array, quantile: float) -> float:
+	if sorted_values.is_empty():
+		return 0.0
+	return sorted_values[mini(int(quantile * (sorted_values.size() - 1)), sorted_values.size() - 1)]
@@ -0,0 +1,209 @@
+/**************************************************************************/
+/*  ddsketch.cpp                                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "ddsketch.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+using namespace godot;
+
+size_t DDSketch::Store::width_with(int32_t p_index) const {
+	if (counts.empty()) {
+		return 1;
+	}
+	int64_t lowest = std::min<int64_t>(offset, p_index);
+	int64_t highest = std::max<int64_t>((int64_t)offset + (int64_t)counts.size() - 1, p_index);
+	return (size_t)(highest - lowest + 1);
+}
+
+void DDSketch::Store::add(int32_t p_index, uint64_t p_count) {
+	if (counts.empty()) {
+		offset = p_index;
+		counts.assign(1, 0);
+	}
+	if (p_index < offset) {
+		counts.insert(counts.begin(), (size_t)(offset - p_index), 0);
+		offset = p_index;
+	} else if ((size_t)(p_index - offset) >= counts.size()) {
+		counts.resize((size_t)(p_index - offset) + 1, 0);
+	}
+	counts[p_index - offset] += p_count;
+}
+
+void DDSketch::Store::downscale() {
+	if (counts.empty()) {
+		return;
+	}
+	// Bucket i of the finer scale lies within bucket floor(i / 2) of the
+	// coarser one. Shifting negative indices rounds down as well.
+	int32_t new_offset = offset >> 1;
+	int32_t new_last = (int32_t)(offset + (int32_t)counts.size() - 1) >> 1;
+	std::vector<uint64_t> merged((size_t)(new_last - new_offset) + 1, 0);
+	for (size_t i = 0; i < counts.size(); i++) {
+		merged[(size_t)(((offset + (int32_t)i) >> 1) - new_offset)] += counts[i];
+	}
+	offset = new_offset;
+	counts.swap(merged);
+}
+
+void DDSketch::Store::clear() {
+	offset = 0;
+	counts.clear();
+}
+
+int DDSketch::scale_for_relative_accuracy(double p_relative_accuracy) {
+	// Smallest scale whose relative error does not exceed the requested one.
+	for (int candidate = -4; candidate < 20; candidate++) {
+		if (relative_accuracy_for_scale(candidate) <= p_relative_accuracy) {
+			return candidate;
+		}
+	}
+	return 20;
+}
+
+double DDSketch::relative_accuracy_for_scale(int p_scale) {
+	double base = std::exp2(std::exp2(-p_scale));
+	return (base - 1.0) / (base + 1.0);
+}
+
+void DDSketch::configure(int p_scale, int p_max_buckets) {
+	configured_scale = std::max(p_scale, MIN_SCALE);
+	max_buckets = std::max(p_max_buckets, MIN_MAX_BUCKETS);
+	clear();
+}
+
+void DDSketch::downscale() {
+	scale--;
+	index_multiplier = std::exp2(scale);
+	positive.downscale();
+	negative.downscale();
+}
+
+int32_t DDSketch::index_of(double p_magnitude) const {
+	// Bucket i holds (base^i, base^(i + 1)], hence ceil() - 1.
+	return (int32_t)std::ceil(std::log2(p_magnitude) * index_multiplier) - 1;
+}
+
+double DDSketch::estimate(int32_t p_index) const {
+	// The point of the bucket with equal relative distance to both bounds.
+	// Written as a harmonic mean so that the outer buckets of low scales,
+	// whose bounds overflow to 0 or infinity, stay finite.
+	double lower = std::exp2((double)p_index / index_multiplier);
+	double upper = std::exp2((double)(p_index + 1) / index_multiplier);
+	return 2.0 / (1.0 / lower + 1.0 / upper);
+}
+
+void DDSketch::add(double p_value) {
+	// NaN and infinities have no bucket index and would poison the sum.
+	if (!std::isfinite(p_value)) {
+		return;
+	}
+	if (count == 0) {
+		min = p_value;
+		max = p_value;
+	} else {
+		min = std::min(min, p_value);
+		max = std::max(max, p_value);
+	}
+	count++;
+	sum += p_value;
+
+	double magnitude = std::fabs(p_value);
+	if (magnitude < DBL_MIN) {
+		zero_count++;
+		return;
+	}
+	Store &store = p_value > 0.0 ? positive : negative;
+	int32_t index = index_of(magnitude);
+	while (store.width_with(index) > (size_t)max_buckets && scale > MIN_SCALE) {
+		downscale();
+		index = index_of(magnitude);
+	}
+	store.add(index, 1);
+}
+
+void DDSketch::clear() {
+	scale = configured_scale;
+	index_multiplier = std::exp2(scale);
+	positive.clear();
+	negative.clear();
+	zero_count = 0;
+	count = 0;
+	sum = 0.0;
+	min = 0.0;
+	max = 0.0;
+}
+
+double DDSketch::quantile(double p_quantile) const {
+	if (count == 0) {
+		return 0.0;
+	}
+	if (p_quantile <= 0.0) {
+		return min;
+	}
+	if (p_quantile >= 1.0) {
+		return max;
+	}
+
+	uint64_t rank = (uint64_t)(p_quantile * (double)(count - 1));
+	uint64_t seen = 0;
+	double result = 0.0;
+	bool found = false;
+
+	// Negative values in ascending order are the largest magnitudes first.
+	for (size_t i = negative.counts.size(); i > 0 && !found; i--) {
+		seen += negative.counts[i - 1];
+		if (seen > rank) {
+			result = -estimate(negative.offset + (int32_t)(i - 1));
+			found = true;
+		}
+	}
+	if (!found) {
+		seen += zero_count;
+		if (seen > rank) {
+			result = 0.0;
+			found = true;
+		}
+	}
+	for (size_t i = 0; i < positive.counts.size() && !found; i++) {
+		seen += positive.counts[i];
+		if (seen > rank) {
+			result = estimate(positive.offset + (int32_t)i);
+			found = true;
+		}
+	}
+	return std::min(std::max(result, min), max);
+}
+
+DDSketch::DDSketch() {
+	configure(DEFAULT_SCALE, DEFAULT_MAX_BUCKETS);
+}
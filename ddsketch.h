@@ -0,0 +1,112 @@
+/**************************************************************************/
+/*  ddsketch.h                                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef DDSKETCH_H
+#define DDSKETCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace godot {
+
+// DDSketch quantile sketch with a bounded number of buckets.
+//
+// Values are mapped with the OTLP exponential histogram mapping: bucket `i`
+// holds values in (base^i, base^(i + 1)] with base = 2^(2^-scale). Quantile
+// estimates therefore have a relative error of at most
+// (base - 1) / (base + 1), and the buckets can be exported unchanged as an
+// ExponentialHistogram. When a store would exceed `max_buckets`, the sketch
+// lowers its scale by one and merges adjacent buckets pairwise, as OTLP
+// exponential histograms do. Memory stays constant and the buckets stay
+// truthful; the relative error becomes that of the coarser scale until the
+// next clear().
+class DDSketch {
+public:
+	static const int DEFAULT_SCALE = 6;
+	static const int DEFAULT_MAX_BUCKETS = 1024;
+	// Lowest scale of the OTLP mapping. Two buckets per sign cover every
+	// normal double at that scale; smaller magnitudes count as zero.
+	static constexpr int MIN_SCALE = -10;
+	static constexpr int MIN_MAX_BUCKETS = 2;
+
+	struct Store {
+		int32_t offset = 0;
+		std::vector<uint64_t> counts;
+
+		// Buckets needed to also hold `p_index`.
+		size_t width_with(int32_t p_index) const;
+		void add(int32_t p_index, uint64_t p_count);
+		// Maps bucket i to bucket floor(i / 2) of the next lower scale.
+		void downscale();
+		void clear();
+	};
+
+private:
+	int configured_scale = DEFAULT_SCALE;
+	int scale = DEFAULT_SCALE;
+	int max_buckets = DEFAULT_MAX_BUCKETS;
+	double index_multiplier = 0.0;
+	Store positive;
+	Store negative;
+	uint64_t zero_count = 0;
+	uint64_t count = 0;
+	double sum = 0.0;
+	double min = 0.0;
+	double max = 0.0;
+
+	int32_t index_of(double p_magnitude) const;
+	void downscale();
+	double estimate(int32_t p_index) const;
+
+public:
+	static int scale_for_relative_accuracy(double p_relative_accuracy);
+	static double relative_accuracy_for_scale(int p_scale);
+
+	void configure(int p_scale, int p_max_buckets);
+	void add(double p_value);
+	void clear();
+	double quantile(double p_quantile) const;
+
+	int get_scale() const { return scale; }
+	uint64_t get_count() const { return count; }
+	double get_sum() const { return sum; }
+	double get_min() const { return min; }
+	double get_max() const { return max; }
+	uint64_t get_zero_count() const { return zero_count; }
+	const Store &get_positive() const { return positive; }
+	const Store &get_negative() const { return negative; }
+
+	DDSketch();
+};
+
+} // namespace godot
+
+#endif // DDSKETCH_H
@@ -0,0 +1,150 @@
+/**************************************************************************/
+/*  engine_logger.cpp                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "engine_logger.h"
+
+#include "log_severity.h"
+
+#include <chrono>
+
+using namespace godot;
+
+bool EngineLogQueue::try_push(EngineLogRecord &&p_record) {
+	size_t position = enqueue_position.load(std::memory_order_relaxed);
+	while (true) {
+		Cell &cell = cells[position & (CAPACITY - 1)];
+		size_t sequence = cell.sequence.load(std::memory_order_acquire);
+		intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+		if (difference == 0) {
+			if (enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+				cell.record = std::move(p_record);
+				cell.sequence.store(position + 1, std::memory_order_release);
+				return true;
+			}
+		} else if (difference < 0) {
+			dropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		} else {
+			position = enqueue_position.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+bool EngineLogQueue::try_pop(EngineLogRecord &r_record) {
+	size_t position = dequeue_position.load(std::memory_order_relaxed);
+	while (true) {
+		Cell &cell = cells[position & (CAPACITY - 1)];
+		size_t sequence = cell.sequence.load(std::memory_order_acquire);
+		intptr_t difference = (intptr_t)sequence - (intptr_t)(position + 1);
+		if (difference == 0) {
+			if (dequeue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+				r_record = std::move(cell.record);
+				cell.sequence.store(position + CAPACITY, std::memory_order_release);
+				return true;
+			}
+		} else if (difference < 0) {
+			return false;
+		} else {
+			position = dequeue_position.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+uint64_t EngineLogQueue::take_dropped() {
+	return dropped.exchange(0, std::memory_order_relaxed);
+}
+
+EngineLogQueue::EngineLogQueue() :
+		cells(new Cell[CAPACITY]) {
+	for (size_t i = 0; i < CAPACITY; i++) {
+		cells[i].sequence.store(i, std::memory_order_relaxed);
+	}
+}
+
+void OpenTelemetryLogger::setup(const std::shared_ptr<EngineLogQueue> &p_queue, SpanContextProvider p_provider, bool p_capture_messages) {
+	queue = p_queue;
+	span_context_provider = p_provider;
+	capture_messages.store(p_capture_messages);
+}
+
+void OpenTelemetryLogger::set_capture_messages(bool p_capture_messages) {
+	capture_messages.store(p_capture_messages, std::memory_order_relaxed);
+}
+
+void OpenTelemetryLogger::set_min_severity(int p_severity_number) {
+	min_severity.store(p_severity_number, std::memory_order_relaxed);
+}
+
+void OpenTelemetryLogger::capture(EngineLogRecord &&p_record) {
+	if (!queue) {
+		return;
+	}
+	p_record.time_unix_nano = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+	if (span_context_provider) {
+		span_context_provider(p_record.span_context);
+	}
+	queue->try_push(std::move(p_record));
+}
+
+void OpenTelemetryLogger::_log_error(const String &p_function, const String &p_file, int32_t p_line, const String &p_code, const String &p_rationale, bool p_editor_notify, int32_t p_error_type, const TypedArray<Ref<ScriptBacktrace>> &p_script_backtraces) {
+	int severity_number = p_error_type == ERROR_TYPE_WARNING ? LogSeverity::SEVERITY_WARN : LogSeverity::SEVERITY_ERROR;
+	if (severity_number < min_severity.load(std::memory_order_relaxed)) {
+		return;
+	}
+	EngineLogRecord record;
+	record.severity_number = severity_number;
+	// The rationale is the readable message when one was given.
+	record.message = (p_rationale.is_empty() ? p_code : p_rationale).utf8().get_data();
+	record.function = p_function.utf8().get_data();
+	record.file = p_file.utf8().get_data();
+	record.line = p_line;
+	record.error_type = p_error_type;
+	for (int i = 0; i < p_script_backtraces.size(); i++) {
+		Ref<ScriptBacktrace> backtrace = p_script_backtraces[i];
+		if (backtrace.is_valid() && !backtrace->is_empty()) {
+			record.backtrace += backtrace->format().utf8().get_data();
+		}
+	}
+	capture(std::move(record));
+}
+
+void OpenTelemetryLogger::_log_message(const String &p_message, bool p_error) {
+	if (!capture_messages.load(std::memory_order_relaxed)) {
+		return;
+	}
+	int severity_number = p_error ? LogSeverity::SEVERITY_ERROR : LogSeverity::SEVERITY_INFO;
+	if (severity_number < min_severity.load(std::memory_order_relaxed)) {
+		return;
+	}
+	EngineLogRecord record;
+	record.severity_number = severity_number;
+	record.message = p_message.strip_edges(false, true).utf8().get_data();
+	capture(std::move(record));
+}
@@ -0,0 +1,126 @@
+/**************************************************************************/
+/*  engine_logger.h                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef ENGINE_LOGGER_H
+#define ENGINE_LOGGER_H
+
+#include <godot_cpp/classes/logger.hpp>
+#include <godot_cpp/classes/script_backtrace.hpp>
+#include <godot_cpp/variant/typed_array.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "span_context.h"
+
+namespace godot {
+
+// One engine log callback, captured on the thread that logged it.
+struct EngineLogRecord {
+	int severity_number = 0; // OTLP SeverityNumber.
+	std::string message;
+	std::string function;
+	std::string file;
+	int line = 0;
+	int error_type = -1; // Logger::ErrorType, -1 for plain messages.
+	std::string backtrace;
+	uint64_t time_unix_nano = 0;
+	SpanContext span_context;
+};
+
+// Bounded multi-producer multi-consumer queue (Vyukov). Each slot carries
+// a sequence number, so producers on any thread claim a slot with one
+// compare-and-swap and never block; a full queue counts the record as
+// dropped instead of waiting.
+class EngineLogQueue {
+public:
+	static const size_t CAPACITY = 4096; // Power of two.
+
+private:
+	struct Cell {
+		std::atomic<size_t> sequence{ 0 };
+		EngineLogRecord record;
+	};
+
+	std::unique_ptr<Cell[]> cells;
+	std::atomic<size_t> enqueue_position{ 0 };
+	std::atomic<size_t> dequeue_position{ 0 };
+	std::atomic<uint64_t> dropped{ 0 };
+
+public:
+	bool try_push(EngineLogRecord &&p_record);
+	bool try_pop(EngineLogRecord &r_record);
+	// Records dropped since the last call.
+	uint64_t take_dropped();
+
+	EngineLogQueue();
+};
+
+// Logger added with OS.add_logger(). The engine calls it for errors,
+// warnings and print output from any thread; records are only captured
+// here and exported from the main thread.
+class OpenTelemetryLogger : public Logger {
+	GDCLASS(OpenTelemetryLogger, Logger);
+
+public:
+	typedef bool (*SpanContextProvider)(SpanContext &r_context);
+
+	// Logger name the minimum severity of engine records is configured for.
+	static constexpr const char *LOGGER_NAME = "godot";
+
+private:
+	std::shared_ptr<EngineLogQueue> queue;
+	SpanContextProvider span_context_provider = nullptr;
+	std::atomic<bool> capture_messages{ true };
+	std::atomic<int> min_severity{ 0 };
+
+	void capture(EngineLogRecord &&p_record);
+
+protected:
+	static void _bind_methods() {}
+
+public:
+	// Only before OS.add_logger(): the engine reads the queue and the
+	// provider from other threads afterwards.
+	void setup(const std::shared_ptr<EngineLogQueue> &p_queue, SpanContextProvider p_provider, bool p_capture_messages);
+	void set_capture_messages(bool p_capture_messages);
+	// Records below this OTLP SeverityNumber are dropped before any of
+	// their strings are converted.
+	void set_min_severity(int p_severity_number);
+
+	void _log_error(const String &p_function, const String &p_file, int32_t p_line, const String &p_code, const String &p_rationale, bool p_editor_notify, int32_t p_error_type, const TypedArray<Ref<ScriptBacktrace>> &p_script_backtraces) override;
+	void _log_message(const String &p_message, bool p_error) override;
+};
+
+} // namespace godot
+
+#endif // ENGINE_LOGGER_H
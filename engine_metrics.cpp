@@ -0,0 +1,109 @@
+/**************************************************************************/
+/*  engine_metrics.cpp                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "engine_metrics.h"
+
+#include <godot_cpp/classes/performance.hpp>
+
+using namespace godot;
+
+namespace {
+
+struct EngineMonitor {
+	Performance::Monitor monitor;
+	uint32_t group;
+	const char *name;
+	const char *unit;
+};
+
+const EngineMonitor engine_monitors[] = {
+	{ Performance::TIME_FPS, EngineMetrics::GROUP_TIME, "godot.time.fps", "{frame}/s" },
+	{ Performance::TIME_PROCESS, EngineMetrics::GROUP_TIME, "godot.time.process", "s" },
+	{ Performance::TIME_PHYSICS_PROCESS, EngineMetrics::GROUP_TIME, "godot.time.physics_process", "s" },
+	{ Performance::TIME_NAVIGATION_PROCESS, EngineMetrics::GROUP_TIME, "godot.time.navigation_process", "s" },
+
+	{ Performance::MEMORY_STATIC, EngineMetrics::GROUP_MEMORY, "godot.memory.static", "By" },
+	{ Performance::MEMORY_STATIC_MAX, EngineMetrics::GROUP_MEMORY, "godot.memory.static_max", "By" },
+	{ Performance::MEMORY_MESSAGE_BUFFER_MAX, EngineMetrics::GROUP_MEMORY, "godot.memory.message_buffer_max", "By" },
+
+	{ Performance::OBJECT_COUNT, EngineMetrics::GROUP_OBJECTS, "godot.object.count", "{object}" },
+	{ Performance::OBJECT_RESOURCE_COUNT, EngineMetrics::GROUP_OBJECTS, "godot.object.resource_count", "{resource}" },
+	{ Performance::OBJECT_NODE_COUNT, EngineMetrics::GROUP_OBJECTS, "godot.object.node_count", "{node}" },
+	{ Performance::OBJECT_ORPHAN_NODE_COUNT, EngineMetrics::GROUP_OBJECTS, "godot.object.orphan_node_count", "{node}" },
+
+	{ Performance::RENDER_TOTAL_OBJECTS_IN_FRAME, EngineMetrics::GROUP_RENDER, "godot.render.objects_in_frame", "{object}" },
+	{ Performance::RENDER_TOTAL_PRIMITIVES_IN_FRAME, EngineMetrics::GROUP_RENDER, "godot.render.primitives_in_frame", "{primitive}" },
+	{ Performance::RENDER_TOTAL_DRAW_CALLS_IN_FRAME, EngineMetrics::GROUP_RENDER, "godot.render.draw_calls_in_frame", "{call}" },
+	{ Performance::RENDER_VIDEO_MEM_USED, EngineMetrics::GROUP_RENDER, "godot.render.video_memory_used", "By" },
+	{ Performance::RENDER_TEXTURE_MEM_USED, EngineMetrics::GROUP_RENDER, "godot.render.texture_memory_used", "By" },
+	{ Performance::RENDER_BUFFER_MEM_USED, EngineMetrics::GROUP_RENDER, "godot.render.buffer_memory_used", "By" },
+
+	{ Performance::PHYSICS_2D_ACTIVE_OBJECTS, EngineMetrics::GROUP_PHYSICS, "godot.physics_2d.active_objects", "{object}" },
+	{ Performance::PHYSICS_2D_COLLISION_PAIRS, EngineMetrics::GROUP_PHYSICS, "godot.physics_2d.collision_pairs", "{pair}" },
+	{ Performance::PHYSICS_2D_ISLAND_COUNT, EngineMetrics::GROUP_PHYSICS, "godot.physics_2d.islands", "{island}" },
+	{ Performance::PHYSICS_3D_ACTIVE_OBJECTS, EngineMetrics::GROUP_PHYSICS, "godot.physics_3d.active_objects", "{object}" },
+	{ Performance::PHYSICS_3D_COLLISION_PAIRS, EngineMetrics::GROUP_PHYSICS, "godot.physics_3d.collision_pairs", "{pair}" },
+	{ Performance::PHYSICS_3D_ISLAND_COUNT, EngineMetrics::GROUP_PHYSICS, "godot.physics_3d.islands", "{island}" },
+
+	{ Performance::NAVIGATION_ACTIVE_MAPS, EngineMetrics::GROUP_NAVIGATION, "godot.navigation.active_maps", "{map}" },
+	{ Performance::NAVIGATION_REGION_COUNT, EngineMetrics::GROUP_NAVIGATION, "godot.navigation.regions", "{region}" },
+	{ Performance::NAVIGATION_AGENT_COUNT, EngineMetrics::GROUP_NAVIGATION, "godot.navigation.agents", "{agent}" },
+	{ Performance::NAVIGATION_LINK_COUNT, EngineMetrics::GROUP_NAVIGATION, "godot.navigation.links", "{link}" },
+	{ Performance::NAVIGATION_POLYGON_COUNT, EngineMetrics::GROUP_NAVIGATION, "godot.navigation.polygons", "{polygon}" },
+	{ Performance::NAVIGATION_EDGE_COUNT, EngineMetrics::GROUP_NAVIGATION, "godot.navigation.edges", "{edge}" },
+	{ Performance::NAVIGATION_EDGE_MERGE_COUNT, EngineMetrics::GROUP_NAVIGATION, "godot.navigation.edges_merged", "{edge}" },
+	{ Performance::NAVIGATION_EDGE_CONNECTION_COUNT, EngineMetrics::GROUP_NAVIGATION, "godot.navigation.edges_connected", "{edge}" },
+	{ Performance::NAVIGATION_EDGE_FREE_COUNT, EngineMetrics::GROUP_NAVIGATION, "godot.navigation.edges_free", "{edge}" },
+};
+
+} // namespace
+
+void EngineMetrics::observe(uint32_t p_groups, MetricViewRegistry &r_views, MetricAggregator &r_aggregator, uint64_t p_time_unix_nano) {
+	if (p_groups == 0) {
+		return;
+	}
+	Performance *performance = Performance::get_singleton();
+	if (!performance) {
+		return;
+	}
+
+	static const std::string no_attributes = "{}";
+	for (const EngineMonitor &entry : engine_monitors) {
+		if (!(p_groups & entry.group)) {
+			continue;
+		}
+		// Views apply to the built-in instruments like to any other.
+		std::shared_ptr<const MetricStream> stream = r_views.resolve(entry.name, MetricAggregator::METRIC_TYPE_GAUGE);
+		if (stream->drop) {
+			continue;
+		}
+		r_aggregator.record(*stream, entry.unit, no_attributes, performance->get_monitor(entry.monitor), p_time_unix_nano);
+	}
+}
@@ -0,0 +1,60 @@
+/**************************************************************************/
+/*  engine_metrics.h                                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef ENGINE_METRICS_H
+#define ENGINE_METRICS_H
+
+#include <cstdint>
+
+#include "metric_aggregator.h"
+#include "metric_view.h"
+
+namespace godot {
+
+// Observable gauges backed by the engine's Performance monitors. They are
+// sampled natively once per collection interval instead of being polled
+// and recorded from scripts every frame.
+class EngineMetrics {
+public:
+	enum Group {
+		GROUP_TIME = 1 << 0,
+		GROUP_MEMORY = 1 << 1,
+		GROUP_OBJECTS = 1 << 2,
+		GROUP_RENDER = 1 << 3,
+		GROUP_PHYSICS = 1 << 4,
+		GROUP_NAVIGATION = 1 << 5,
+	};
+
+	static void observe(uint32_t p_groups, MetricViewRegistry &r_views, MetricAggregator &r_aggregator, uint64_t p_time_unix_nano);
+};
+
+} // namespace godot
+
+#endif // ENGINE_METRICS_H
@@ -0,0 +1,83 @@
+/**************************************************************************/
+/*  frame_profiler.cpp                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "frame_profiler.h"
+
+#include <godot_cpp/classes/engine.hpp>
+
+#include <algorithm>
+
+using namespace godot;
+
+const char *OpenTelemetryProfiler::PROFILER_NAME = "opentelemetry";
+
+void OpenTelemetryProfiler::set_callback(const FrameCallback &p_callback) {
+	callback = p_callback;
+}
+
+void OpenTelemetryProfiler::set_frame_interval(int p_frame_interval) {
+	frame_interval = std::max(p_frame_interval, 1);
+}
+
+void OpenTelemetryProfiler::_toggle(bool p_enable, const Array &p_options) {
+	enabled = p_enable;
+	tick_count = 0;
+	frame.sections.clear();
+}
+
+void OpenTelemetryProfiler::_add_frame(const Array &p_data) {
+	if (!enabled) {
+		return;
+	}
+	for (int i = 0; i < p_data.size(); i++) {
+		if (p_data[i].get_type() != Variant::ARRAY) {
+			continue;
+		}
+		Array section = p_data[i];
+		if (section.size() >= 2) {
+			frame.sections.emplace_back(String(section[0]).utf8().get_data(), (double)section[1]);
+		}
+	}
+}
+
+void OpenTelemetryProfiler::_tick(double p_frame_time, double p_process_time, double p_physics_time, double p_physics_frame_time) {
+	if (!enabled || !callback) {
+		return;
+	}
+	if (tick_count++ % (uint64_t)frame_interval == 0) {
+		frame.frame = Engine::get_singleton()->get_process_frames();
+		frame.frame_time = p_frame_time;
+		frame.process_time = p_process_time;
+		frame.physics_time = p_physics_time;
+		frame.physics_frame_time = p_physics_frame_time;
+		callback(frame);
+	}
+	frame.sections.clear();
+}
@@ -0,0 +1,91 @@
+/**************************************************************************/
+/*  frame_profiler.h                                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef FRAME_PROFILER_H
+#define FRAME_PROFILER_H
+
+#include <godot_cpp/classes/engine_profiler.hpp>
+#include <godot_cpp/variant/array.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace godot {
+
+// EngineProfiler registered with the EngineDebugger. The engine calls
+// _tick() natively once per frame with the frame, process and physics
+// times, so frames are measured without any per-frame script call. Named
+// section timings posted with
+// `EngineDebugger.profiler_add_frame_data("opentelemetry", [[name, sec], ...])`
+// are attached to the next frame. Only every `frame_interval`-th frame is
+// passed on to the callback.
+class OpenTelemetryProfiler : public EngineProfiler {
+	GDCLASS(OpenTelemetryProfiler, EngineProfiler);
+
+public:
+	static const char *PROFILER_NAME;
+	static const int DEFAULT_FRAME_INTERVAL = 60;
+
+	struct Frame {
+		uint64_t frame = 0;
+		double frame_time = 0.0;
+		double process_time = 0.0;
+		double physics_time = 0.0;
+		double physics_frame_time = 0.0;
+		std::vector<std::pair<std::string, double>> sections;
+	};
+
+	typedef std::function<void(const Frame &)> FrameCallback;
+
+private:
+	FrameCallback callback;
+	int frame_interval = DEFAULT_FRAME_INTERVAL;
+	uint64_t tick_count = 0;
+	bool enabled = false;
+	Frame frame;
+
+protected:
+	static void _bind_methods() {}
+
+public:
+	void set_callback(const FrameCallback &p_callback);
+	void set_frame_interval(int p_frame_interval);
+
+	void _toggle(bool p_enable, const Array &p_options) override;
+	void _add_frame(const Array &p_data) override;
+	void _tick(double p_frame_time, double p_process_time, double p_physics_time, double p_physics_frame_time) override;
+};
+
+} // namespace godot
+
+#endif // FRAME_PROFILER_H
@@ -0,0 +1,171 @@
+/**************************************************************************/
+/*  log_dedup.cpp                                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "log_dedup.h"
+
+#include <algorithm>
+
+using namespace godot;
+
+const char *LogDeduplicator::COUNT_ATTRIBUTE = "godot.log.repeat_count";
+const char *LogDeduplicator::FIRST_TIME_ATTRIBUTE = "godot.log.first_time_unix_nano";
+const char *LogDeduplicator::LAST_TIME_ATTRIBUTE = "godot.log.last_time_unix_nano";
+
+static void hash_bytes(uint64_t &r_hash, const std::string &p_bytes) {
+	for (char c : p_bytes) {
+		r_hash ^= (uint8_t)c;
+		r_hash *= 0x100000001b3ULL;
+	}
+	// Separates fields so "ab" + "c" and "a" + "bc" differ.
+	r_hash ^= 0xff;
+	r_hash *= 0x100000001b3ULL;
+}
+
+uint64_t LogDeduplicator::hash_record(const LogRecordData &p_record) {
+	// FNV-1a over the key fields.
+	uint64_t hash = 0xcbf29ce484222325ULL ^ (uint64_t)p_record.severity_number;
+	hash_bytes(hash, p_record.message);
+	hash_bytes(hash, p_record.attributes);
+	return hash;
+}
+
+bool LogDeduplicator::same_key(const LogRecordData &p_a, const LogRecordData &p_b) {
+	return p_a.severity_number == p_b.severity_number && p_a.message == p_b.message && p_a.attributes == p_b.attributes;
+}
+
+bool LogDeduplicator::try_acquire(Entry &p_entry, uint64_t p_now_nsec) {
+	if (emission_interval_nsec == 0) {
+		return true;
+	}
+	int64_t now = (int64_t)p_now_nsec;
+	if (p_entry.theoretical_arrival - now > burst_tolerance_nsec) {
+		return false;
+	}
+	p_entry.theoretical_arrival = std::max(p_entry.theoretical_arrival, now) + emission_interval_nsec;
+	return true;
+}
+
+void LogDeduplicator::summarize(Entry &p_entry, LogRecordData &r_record) {
+	r_record = p_entry.record;
+	r_record.time_unix_nano = p_entry.last_time;
+	std::string fields = "\"" + std::string(COUNT_ATTRIBUTE) + "\":" + std::to_string(p_entry.count) +
+			",\"" + FIRST_TIME_ATTRIBUTE + "\":" + std::to_string(p_entry.first_time) +
+			",\"" + LAST_TIME_ATTRIBUTE + "\":" + std::to_string(p_entry.last_time);
+	// Attributes are a JSON object; the fields go before its closing brace.
+	size_t close = r_record.attributes.find_last_of('}');
+	if (close == std::string::npos) {
+		r_record.attributes = "{" + fields + "}";
+	} else {
+		bool empty = r_record.attributes.find_first_not_of(" \t\r\n", r_record.attributes.find('{') + 1) == close;
+		r_record.attributes.insert(close, empty ? fields : "," + fields);
+	}
+	p_entry.count = 0;
+}
+
+void LogDeduplicator::configure(double p_window_sec, double p_records_per_second, int p_burst) {
+	window_nsec = p_window_sec > 0.0 ? (uint64_t)(p_window_sec * 1e9) : 0;
+	if (p_records_per_second > 0.0) {
+		double rate = std::max(p_records_per_second, 0.001);
+		emission_interval_nsec = std::max((int64_t)(1e9 / rate), (int64_t)1);
+		burst_tolerance_nsec = emission_interval_nsec * (int64_t)(std::clamp(p_burst, 1, 1000000) - 1);
+	} else {
+		emission_interval_nsec = 0;
+		burst_tolerance_nsec = 0;
+	}
+	if (window_nsec == 0) {
+		entries.clear();
+	}
+}
+
+bool LogDeduplicator::offer(const LogRecordData &p_record) {
+	if (window_nsec == 0) {
+		return true;
+	}
+	uint64_t now = p_record.time_unix_nano;
+	uint64_t key = hash_record(p_record);
+	std::unordered_map<uint64_t, Entry>::iterator it = entries.find(key);
+	if (it == entries.end()) {
+		if (entries.size() >= MAX_KEYS) {
+			return true;
+		}
+		it = entries.emplace(key, Entry()).first;
+		it->second.record = p_record;
+	} else if (!same_key(it->second.record, p_record)) {
+		// Hash collision: leave the tracked key alone.
+		return true;
+	}
+
+	Entry &entry = it->second;
+	if (now < entry.window_end) {
+		if (entry.count == 0) {
+			entry.first_time = now;
+		}
+		entry.count++;
+		entry.last_time = now;
+		return false;
+	}
+	if (entry.count > 0) {
+		// The window ended but was not collected yet; this record joins the
+		// summary, which collect() writes next.
+		entry.count++;
+		entry.last_time = now;
+		return false;
+	}
+	entry.window_end = now + window_nsec;
+	if (!try_acquire(entry, now)) {
+		entry.count = 1;
+		entry.first_time = now;
+		entry.last_time = now;
+		return false;
+	}
+	return true;
+}
+
+void LogDeduplicator::collect(uint64_t p_now_nsec, bool p_all, std::vector<LogRecordData> &r_records) {
+	for (std::unordered_map<uint64_t, Entry>::iterator it = entries.begin(); it != entries.end();) {
+		Entry &entry = it->second;
+		bool ended = p_all || p_now_nsec >= entry.window_end;
+		if (ended && entry.count > 0) {
+			if (p_all || try_acquire(entry, p_now_nsec)) {
+				r_records.emplace_back();
+				summarize(entry, r_records.back());
+			} else {
+				entry.window_end = p_now_nsec + window_nsec;
+			}
+		}
+		// Keys are kept while their window or rate limit still applies.
+		bool idle = ended && entry.count == 0 && entry.theoretical_arrival <= (int64_t)p_now_nsec;
+		if (idle) {
+			it = entries.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
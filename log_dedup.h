@@ -0,0 +1,111 @@
+/**************************************************************************/
+/*  log_dedup.h                                                           */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef LOG_DEDUP_H
+#define LOG_DEDUP_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "span_context.h"
+
+namespace godot {
+
+// A log record on its way into the logs buffer.
+struct LogRecordData {
+	int severity_number = 0;
+	std::string level;
+	std::string message;
+	std::string attributes = "{}"; // JSON object.
+	// var_to_str() of the argument Array when `message` is a template
+	// rendered at export, empty otherwise.
+	std::string template_args;
+	uint64_t time_unix_nano = 0;
+	SpanContext span_context;
+};
+
+// Collapses repeated log records, like syslog's "last message repeated".
+//
+// Records are keyed on (severity, message, attributes); template arguments
+// are not part of the key, so a template logged with changing values still
+// collapses and its summary carries the first arguments. The first record
+// of a key is written immediately and opens a window; repeats within the
+// window are only counted. When the window ends, one record carrying the
+// repeat count and the first and last timestamps is written in their
+// place. Each key also has a token bucket (GCRA) limiting how many records
+// it writes per second; a window whose summary finds the bucket empty is
+// extended and keeps counting.
+//
+// Memory is bounded: at most MAX_KEYS keys are tracked and records of
+// further keys pass through unchanged. Not thread-safe; callers serialize.
+class LogDeduplicator {
+public:
+	static const size_t MAX_KEYS = 1024;
+	static const char *COUNT_ATTRIBUTE;
+	static const char *FIRST_TIME_ATTRIBUTE;
+	static const char *LAST_TIME_ATTRIBUTE;
+
+private:
+	struct Entry {
+		LogRecordData record;
+		uint64_t window_end = 0;
+		uint64_t count = 0; // Repeats not written yet.
+		uint64_t first_time = 0;
+		uint64_t last_time = 0;
+		int64_t theoretical_arrival = 0;
+	};
+
+	uint64_t window_nsec = 0;
+	int64_t emission_interval_nsec = 0; // 0 disables rate limiting.
+	int64_t burst_tolerance_nsec = 0;
+	std::unordered_map<uint64_t, Entry> entries;
+
+	static uint64_t hash_record(const LogRecordData &p_record);
+	static bool same_key(const LogRecordData &p_a, const LogRecordData &p_b);
+	bool try_acquire(Entry &p_entry, uint64_t p_now_nsec);
+	void summarize(Entry &p_entry, LogRecordData &r_record);
+
+public:
+	// A window of 0 disables deduplication. A rate of 0 disables the
+	// per-key limit.
+	void configure(double p_window_sec, double p_records_per_second, int p_burst);
+	bool is_enabled() const { return window_nsec > 0; }
+	// Returns true if the record should be written now.
+	bool offer(const LogRecordData &p_record);
+	// Appends the summaries of windows ended by p_now_nsec, or of all
+	// windows when p_all is set, and forgets idle keys.
+	void collect(uint64_t p_now_nsec, bool p_all, std::vector<LogRecordData> &r_records);
+};
+
+} // namespace godot
+
+#endif // LOG_DEDUP_H
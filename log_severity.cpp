@@ -0,0 +1,95 @@
+/**************************************************************************/
+/*  log_severity.cpp                                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "log_severity.h"
+
+using namespace godot;
+
+namespace {
+
+struct SeverityName {
+	const char *name;
+	int severity_number;
+};
+
+const SeverityName severity_names[] = {
+	{ "TRACE", LogSeverity::SEVERITY_TRACE },
+	{ "DEBUG", LogSeverity::SEVERITY_DEBUG },
+	{ "INFO", LogSeverity::SEVERITY_INFO },
+	{ "WARN", LogSeverity::SEVERITY_WARN },
+	{ "WARNING", LogSeverity::SEVERITY_WARN },
+	{ "ERROR", LogSeverity::SEVERITY_ERROR },
+	{ "FATAL", LogSeverity::SEVERITY_FATAL },
+	{ "CRITICAL", LogSeverity::SEVERITY_FATAL },
+};
+
+const char *severity_texts[] = {
+	"UNSPECIFIED",
+	"TRACE", "TRACE2", "TRACE3", "TRACE4",
+	"DEBUG", "DEBUG2", "DEBUG3", "DEBUG4",
+	"INFO", "INFO2", "INFO3", "INFO4",
+	"WARN", "WARN2", "WARN3", "WARN4",
+	"ERROR", "ERROR2", "ERROR3", "ERROR4",
+	"FATAL", "FATAL2", "FATAL3", "FATAL4",
+};
+
+} // namespace
+
+const char *LogSeverity::get_text(int p_severity_number) {
+	if (p_severity_number < 0 || p_severity_number > SEVERITY_MAX) {
+		return severity_texts[SEVERITY_UNSPECIFIED];
+	}
+	return severity_texts[p_severity_number];
+}
+
+int LogSeverity::parse(const char32_t *p_text, int64_t p_length) {
+	// An optional trailing digit 1-4 selects the number within the level.
+	int offset = 0;
+	if (p_length > 1 && p_text[p_length - 1] >= U'1' && p_text[p_length - 1] <= U'4') {
+		offset = (int)(p_text[p_length - 1] - U'1');
+		p_length--;
+	}
+	for (const SeverityName &entry : severity_names) {
+		int64_t i = 0;
+		for (; i < p_length && entry.name[i]; i++) {
+			char32_t c = p_text[i];
+			if (c >= U'a' && c <= U'z') {
+				c -= U'a' - U'A';
+			}
+			if (c != (char32_t)entry.name[i]) {
+				break;
+			}
+		}
+		if (i == p_length && entry.name[i] == '\0') {
+			return entry.severity_number + offset;
+		}
+	}
+	return SEVERITY_UNSPECIFIED;
+}
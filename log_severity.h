@@ -0,0 +1,62 @@
+/**************************************************************************/
+/*  log_severity.h                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef LOG_SEVERITY_H
+#define LOG_SEVERITY_H
+
+#include <cstdint>
+
+namespace godot {
+
+// OTLP SeverityNumber values and their short SeverityText names. Each
+// level spans four numbers, e.g. WARN, WARN2, WARN3, WARN4 = 13..16.
+class LogSeverity {
+public:
+	enum Severity {
+		SEVERITY_UNSPECIFIED = 0,
+		SEVERITY_TRACE = 1,
+		SEVERITY_DEBUG = 5,
+		SEVERITY_INFO = 9,
+		SEVERITY_WARN = 13,
+		SEVERITY_ERROR = 17,
+		SEVERITY_FATAL = 21,
+		SEVERITY_MAX = 24,
+	};
+
+	static const char *get_text(int p_severity_number);
+	// Case-insensitive SeverityText such as "warn", "ERROR3" or the common
+	// aliases "warning" and "critical". Works on the UTF-32 text directly
+	// so callers do not have to convert it. Unknown text is unspecified.
+	static int parse(const char32_t *p_text, int64_t p_length);
+};
+
+} // namespace godot
+
+#endif // LOG_SEVERITY_H
@@ -0,0 +1,420 @@
+/**************************************************************************/
+/*  metric_aggregator.cpp                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "metric_aggregator.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <tuple>
+
+using namespace godot;
+
+const char *MetricAggregator::OVERFLOW_ATTRIBUTES = "{\"otel.metric.overflow\":true}";
+const char *MetricAggregator::ACTIVE_SERIES_METRIC = "otel.sdk.metric.active_series";
+
+const std::vector<double> &MetricAggregator::default_bucket_bounds() {
+	// Default explicit bucket boundaries from the metrics SDK specification.
+	static const std::vector<double> bounds = { 0.0, 5.0, 10.0, 25.0, 50.0, 75.0, 100.0, 250.0, 500.0, 750.0, 1000.0, 2500.0, 5000.0, 7500.0, 10000.0 };
+	return bounds;
+}
+
+std::string MetricAggregator::escape_json(const std::string &p_string) {
+	std::string escaped;
+	escaped.reserve(p_string.size());
+	for (char c : p_string) {
+		switch (c) {
+			case '"':
+				escaped += "\\\"";
+				break;
+			case '\\':
+				escaped += "\\\\";
+				break;
+			default:
+				if ((unsigned char)c < 0x20) {
+					char buffer[7];
+					snprintf(buffer, sizeof(buffer), "\\u%04x", (unsigned int)c);
+					escaped += buffer;
+				} else {
+					escaped += c;
+				}
+				break;
+		}
+	}
+	return escaped;
+}
+
+uint64_t MetricAggregator::next_random(uint64_t p_bound) {
+	// xorshift64*, cheap enough for the recording path.
+	random_state ^= random_state >> 12;
+	random_state ^= random_state << 25;
+	random_state ^= random_state >> 27;
+	return (random_state * 0x2545F4914F6CDD1DULL) % p_bound;
+}
+
+void MetricAggregator::store_exemplar(MetricExemplar &r_exemplar, double p_value, uint64_t p_time_unix_nano, const SpanContext *p_span_context) {
+	r_exemplar.value = p_value;
+	r_exemplar.time_unix_nano = p_time_unix_nano;
+	if (p_span_context && p_span_context->is_valid()) {
+		r_exemplar.trace_id = p_span_context->trace_id;
+		r_exemplar.span_id = p_span_context->span_id;
+	} else {
+		r_exemplar.trace_id.clear();
+		r_exemplar.span_id.clear();
+	}
+}
+
+void MetricAggregator::offer_exemplar(Series &r_series, const Instrument &p_instrument, size_t p_bucket, double p_value, uint64_t p_time_unix_nano, const SpanContext *p_span_context) {
+	if (p_instrument.type == METRIC_TYPE_HISTOGRAM) {
+		// AlignedHistogramBucket: one exemplar per bucket, replaced with
+		// probability 1/n so every measurement in the bucket is equally likely.
+		if (r_series.exemplars.size() != r_series.bucket_counts.size()) {
+			r_series.exemplars.assign(r_series.bucket_counts.size(), MetricExemplar());
+			r_series.bucket_exemplar_offers.assign(r_series.bucket_counts.size(), 0);
+		}
+		uint64_t seen = ++r_series.bucket_exemplar_offers[p_bucket];
+		if (seen == 1 || next_random(seen) == 0) {
+			store_exemplar(r_series.exemplars[p_bucket], p_value, p_time_unix_nano, p_span_context);
+		}
+		return;
+	}
+
+	// SimpleFixedSize: classic reservoir sampling over the collection cycle.
+	r_series.exemplar_offers++;
+	if (r_series.exemplars.size() < (size_t)exemplar_reservoir_size) {
+		r_series.exemplars.emplace_back();
+		store_exemplar(r_series.exemplars.back(), p_value, p_time_unix_nano, p_span_context);
+		return;
+	}
+	uint64_t slot = next_random(r_series.exemplar_offers);
+	if (slot < r_series.exemplars.size()) {
+		store_exemplar(r_series.exemplars[slot], p_value, p_time_unix_nano, p_span_context);
+	}
+}
+
+size_t MetricAggregator::record_into(Series &r_series, const Instrument &p_instrument, double p_value, uint64_t p_time_unix_nano) {
+	if (r_series.count == 0) {
+		r_series.min = p_value;
+		r_series.max = p_value;
+		if (r_series.start_time_unix_nano == 0) {
+			r_series.start_time_unix_nano = p_time_unix_nano;
+		}
+	} else {
+		r_series.min = std::min(r_series.min, p_value);
+		r_series.max = std::max(r_series.max, p_value);
+	}
+	r_series.count++;
+	r_series.sum += p_value;
+	r_series.last = p_value;
+	r_series.last_time_unix_nano = p_time_unix_nano;
+
+	if (p_instrument.type == METRIC_TYPE_HISTOGRAM) {
+		const std::vector<double> &bounds = p_instrument.bucket_bounds;
+		if (r_series.bucket_counts.size() != bounds.size() + 1) {
+			r_series.bucket_counts.assign(bounds.size() + 1, 0);
+		}
+		// Buckets are upper-inclusive: (bounds[i - 1], bounds[i]].
+		size_t bucket = std::lower_bound(bounds.begin(), bounds.end(), p_value) - bounds.begin();
+		r_series.bucket_counts[bucket]++;
+		return bucket;
+	}
+	if (p_instrument.type == METRIC_TYPE_SKETCH) {
+		r_series.sketch.add(p_value);
+	}
+	return 0;
+}
+
+MetricAggregator::Instrument &MetricAggregator::get_or_create_instrument(const MetricStream &p_stream, const std::string &p_unit) {
+	auto it = instruments.find(p_stream.name);
+	if (it != instruments.end()) {
+		return it->second;
+	}
+	Instrument &instrument = instruments[p_stream.name];
+	instrument.unit = p_unit;
+	instrument.type = p_stream.type;
+	instrument.view_cardinality_limit = p_stream.cardinality_limit;
+	instrument.cardinality_limit = resolve_cardinality_limit(p_stream.name, instrument);
+	if (p_stream.type == METRIC_TYPE_HISTOGRAM) {
+		instrument.bucket_bounds = p_stream.has_bucket_bounds ? p_stream.bucket_bounds : default_bucket_bounds();
+	}
+	instrument.sketch_scale = sketch_scale;
+	instrument.sketch_max_buckets = sketch_max_buckets;
+	return instrument;
+}
+
+int MetricAggregator::resolve_cardinality_limit(const std::string &p_name, const Instrument &p_instrument) const {
+	if (p_instrument.view_cardinality_limit > 0) {
+		return p_instrument.view_cardinality_limit;
+	}
+	auto it = cardinality_limits.find(p_name);
+	if (it != cardinality_limits.end()) {
+		return it->second;
+	}
+	return default_cardinality_limit;
+}
+
+void MetricAggregator::record(const MetricStream &p_stream, const std::string &p_unit, const std::string &p_attributes, double p_value, uint64_t p_time_unix_nano, const SpanContext *p_span_context) {
+	std::lock_guard<std::mutex> lock(mutex);
+	Instrument &instrument = get_or_create_instrument(p_stream, p_unit);
+
+	auto it = instrument.series.find(p_attributes);
+	if (it == instrument.series.end()) {
+		// One slot is always kept free for the overflow series, so the
+		// instrument never reports more than `cardinality_limit` points.
+		bool has_room = instrument.cardinality_limit <= 0 || instrument.series.size() + 1 < (size_t)instrument.cardinality_limit;
+		auto inserted = instrument.series.emplace(has_room ? p_attributes : std::string(OVERFLOW_ATTRIBUTES), Series());
+		if (inserted.second) {
+			total_series_count.fetch_add(1, std::memory_order_relaxed);
+			if (instrument.type == METRIC_TYPE_SKETCH) {
+				inserted.first->second.sketch.configure(instrument.sketch_scale, instrument.sketch_max_buckets);
+			}
+		}
+		it = inserted.first;
+	}
+	size_t bucket = record_into(it->second, instrument, p_value, p_time_unix_nano);
+
+	bool sample = exemplar_filter == EXEMPLAR_FILTER_ALWAYS_ON ||
+			(exemplar_filter == EXEMPLAR_FILTER_TRACE_BASED && p_span_context && p_span_context->sampled && p_span_context->is_valid());
+	if (sample) {
+		offer_exemplar(it->second, instrument, bucket, p_value, p_time_unix_nano, p_span_context);
+	}
+}
+
+MetricPoint MetricAggregator::make_point(const std::string &p_name, const Instrument &p_instrument, const std::string &p_attributes, const Series &p_series, uint64_t p_time_unix_nano) const {
+	MetricPoint point;
+	point.name = p_name;
+	point.unit = p_instrument.unit;
+	point.type = p_instrument.type;
+	point.temporality = temporality;
+	point.attributes = p_attributes;
+	point.start_time_unix_nano = p_series.start_time_unix_nano;
+	point.time_unix_nano = p_time_unix_nano;
+	point.value = p_instrument.type == METRIC_TYPE_GAUGE ? p_series.last : p_series.sum;
+	point.count = p_series.count;
+	point.sum = p_series.sum;
+	point.min = p_series.min;
+	point.max = p_series.max;
+	if (p_instrument.type == METRIC_TYPE_HISTOGRAM) {
+		point.bucket_bounds = p_instrument.bucket_bounds;
+		point.bucket_counts = p_series.bucket_counts;
+	}
+	if (p_instrument.type == METRIC_TYPE_SKETCH) {
+		const DDSketch &sketch = p_series.sketch;
+		point.scale = sketch.get_scale();
+		point.zero_count = sketch.get_zero_count();
+		point.positive_offset = sketch.get_positive().offset;
+		point.positive_bucket_counts = sketch.get_positive().counts;
+		point.negative_offset = sketch.get_negative().offset;
+		point.negative_bucket_counts = sketch.get_negative().counts;
+		point.quantiles = sketch_quantiles;
+		point.quantile_values.reserve(sketch_quantiles.size());
+		for (double quantile : sketch_quantiles) {
+			point.quantile_values.push_back(sketch.quantile(quantile));
+		}
+	}
+	for (const MetricExemplar &exemplar : p_series.exemplars) {
+		if (exemplar.time_unix_nano != 0) {
+			point.exemplars.push_back(exemplar);
+		}
+	}
+	return point;
+}
+
+MetricPoint MetricAggregator::make_active_series_point(const std::string &p_name, const Instrument &p_instrument, uint64_t p_time_unix_nano) const {
+	MetricPoint point;
+	point.name = ACTIVE_SERIES_METRIC;
+	point.unit = "{series}";
+	point.type = METRIC_TYPE_GAUGE;
+	point.temporality = temporality;
+	point.attributes = "{\"otel.metric.name\":\"" + escape_json(p_name) + "\"}";
+	point.start_time_unix_nano = p_time_unix_nano;
+	point.time_unix_nano = p_time_unix_nano;
+	point.value = (double)p_instrument.series.size();
+	point.count = 1;
+	point.sum = point.value;
+	point.min = point.value;
+	point.max = point.value;
+	return point;
+}
+
+void MetricAggregator::collect(uint64_t p_time_unix_nano, std::vector<MetricPoint> &r_points) {
+	std::lock_guard<std::mutex> lock(mutex);
+	bool delta = temporality == TEMPORALITY_DELTA;
+
+	for (auto &instrument_entry : instruments) {
+		const std::string &name = instrument_entry.first;
+		Instrument &instrument = instrument_entry.second;
+
+		for (auto it = instrument.series.begin(); it != instrument.series.end();) {
+			Series &series = it->second;
+			if (series.count == 0) {
+				// With delta temporality a series that saw no measurements
+				// during a whole collection cycle is stale and is evicted.
+				if (delta) {
+					it = instrument.series.erase(it);
+					total_series_count.fetch_sub(1, std::memory_order_relaxed);
+					continue;
+				}
+				if (instrument.type == METRIC_TYPE_GAUGE) {
+					++it;
+					continue;
+				}
+			}
+
+			r_points.push_back(make_point(name, instrument, it->first, series, p_time_unix_nano));
+
+			// Exemplars describe the most recent collection cycle only.
+			series.exemplars.clear();
+			series.exemplar_offers = 0;
+			series.bucket_exemplar_offers.clear();
+
+			if (delta) {
+				series.count = 0;
+				series.sum = 0.0;
+				series.start_time_unix_nano = p_time_unix_nano;
+				std::fill(series.bucket_counts.begin(), series.bucket_counts.end(), 0);
+				series.sketch.clear();
+			}
+			++it;
+		}
+
+		if (self_metrics_enabled) {
+			r_points.push_back(make_active_series_point(name, instrument, p_time_unix_nano));
+		}
+	}
+}
+
+void MetricAggregator::get_instrument_names(std::vector<std::string> &r_names) {
+	std::lock_guard<std::mutex> lock(mutex);
+	r_names.reserve(r_names.size() + instruments.size() + 1);
+	for (const auto &instrument_entry : instruments) {
+		r_names.push_back(instrument_entry.first);
+	}
+	if (self_metrics_enabled && !instruments.empty()) {
+		r_names.push_back(ACTIVE_SERIES_METRIC);
+	}
+}
+
+void MetricAggregator::snapshot(const std::string &p_name, uint64_t p_time_unix_nano, std::vector<MetricPoint> &r_points) {
+	// Unlike collect(), this leaves the series untouched and only holds the
+	// lock for one instrument, so pull exporters can render incrementally.
+	std::lock_guard<std::mutex> lock(mutex);
+	if (p_name == ACTIVE_SERIES_METRIC && self_metrics_enabled) {
+		for (const auto &instrument_entry : instruments) {
+			r_points.push_back(make_active_series_point(instrument_entry.first, instrument_entry.second, p_time_unix_nano));
+		}
+		return;
+	}
+	auto it = instruments.find(p_name);
+	if (it == instruments.end()) {
+		return;
+	}
+	const Instrument &instrument = it->second;
+	for (const auto &series_entry : instrument.series) {
+		if (series_entry.second.count == 0 && instrument.type == METRIC_TYPE_GAUGE) {
+			continue;
+		}
+		r_points.push_back(make_point(p_name, instrument, series_entry.first, series_entry.second, p_time_unix_nano));
+	}
+}
+
+void MetricAggregator::clear() {
+	std::lock_guard<std::mutex> lock(mutex);
+	instruments.clear();
+	total_series_count.store(0, std::memory_order_relaxed);
+}
+
+void MetricAggregator::set_temporality(int p_temporality) {
+	std::lock_guard<std::mutex> lock(mutex);
+	temporality = p_temporality == TEMPORALITY_CUMULATIVE ? TEMPORALITY_CUMULATIVE : TEMPORALITY_DELTA;
+}
+
+int MetricAggregator::get_temporality() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return temporality;
+}
+
+void MetricAggregator::set_default_cardinality_limit(int p_limit) {
+	std::lock_guard<std::mutex> lock(mutex);
+	default_cardinality_limit = p_limit;
+	for (auto &instrument_entry : instruments) {
+		instrument_entry.second.cardinality_limit = resolve_cardinality_limit(instrument_entry.first, instrument_entry.second);
+	}
+}
+
+void MetricAggregator::set_cardinality_limit(const std::string &p_name, int p_limit) {
+	std::lock_guard<std::mutex> lock(mutex);
+	cardinality_limits[p_name] = p_limit;
+	auto it = instruments.find(p_name);
+	if (it != instruments.end()) {
+		it->second.cardinality_limit = resolve_cardinality_limit(p_name, it->second);
+	}
+}
+
+void MetricAggregator::set_self_metrics_enabled(bool p_enabled) {
+	std::lock_guard<std::mutex> lock(mutex);
+	self_metrics_enabled = p_enabled;
+}
+
+void MetricAggregator::set_exemplar_filter(int p_filter) {
+	std::lock_guard<std::mutex> lock(mutex);
+	exemplar_filter = p_filter;
+}
+
+void MetricAggregator::set_exemplar_reservoir_size(int p_size) {
+	std::lock_guard<std::mutex> lock(mutex);
+	exemplar_reservoir_size = std::max(p_size, 1);
+}
+
+void MetricAggregator::set_sketch_relative_accuracy(double p_relative_accuracy) {
+	// Only instruments created afterwards pick up the new mapping, so that
+	// existing series keep mergeable buckets.
+	std::lock_guard<std::mutex> lock(mutex);
+	sketch_scale = DDSketch::scale_for_relative_accuracy(p_relative_accuracy);
+}
+
+void MetricAggregator::set_sketch_max_buckets(int p_max_buckets) {
+	std::lock_guard<std::mutex> lock(mutex);
+	sketch_max_buckets = std::max(p_max_buckets, DDSketch::MIN_MAX_BUCKETS);
+}
+
+void MetricAggregator::set_sketch_quantiles(const std::vector<double> &p_quantiles) {
+	std::lock_guard<std::mutex> lock(mutex);
+	sketch_quantiles.clear();
+	for (double quantile : p_quantiles) {
+		sketch_quantiles.push_back(std::min(std::max(quantile, 0.0), 1.0));
+	}
+	std::sort(sketch_quantiles.begin(), sketch_quantiles.end());
+}
+
+size_t MetricAggregator::get_series_count(const std::string &p_name) {
+	std::lock_guard<std::mutex> lock(mutex);
+	auto it = instruments.find(p_name);
+	return it != instruments.end() ? it->second.series.size() : 0;
+}
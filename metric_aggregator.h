@@ -0,0 +1,198 @@
+/**************************************************************************/
+/*  metric_aggregator.h                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef METRIC_AGGREGATOR_H
+#define METRIC_AGGREGATOR_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ddsketch.h"
+#include "metric_view.h"
+#include "span_context.h"
+
+namespace godot {
+
+// A sampled measurement kept alongside an aggregated point, linking it to
+// the span that was current when it was recorded.
+struct MetricExemplar {
+	double value = 0.0;
+	uint64_t time_unix_nano = 0;
+	std::string trace_id;
+	std::string span_id;
+};
+
+// A single aggregated data point produced by MetricAggregator::collect().
+struct MetricPoint {
+	std::string name;
+	std::string unit;
+	int type = 0;
+	int temporality = 0;
+	std::string attributes; // Canonical (sorted) JSON object.
+	uint64_t start_time_unix_nano = 0;
+	uint64_t time_unix_nano = 0;
+	double value = 0.0; // Sum for counters, last value for gauges.
+	uint64_t count = 0;
+	double sum = 0.0;
+	double min = 0.0;
+	double max = 0.0;
+	std::vector<double> bucket_bounds;
+	std::vector<uint64_t> bucket_counts;
+	// Sketch instruments: exponential histogram buckets and the configured
+	// quantiles estimated from them.
+	int scale = 0;
+	uint64_t zero_count = 0;
+	int32_t positive_offset = 0;
+	std::vector<uint64_t> positive_bucket_counts;
+	int32_t negative_offset = 0;
+	std::vector<uint64_t> negative_bucket_counts;
+	std::vector<double> quantiles;
+	std::vector<double> quantile_values;
+	std::vector<MetricExemplar> exemplars;
+};
+
+// Native in-memory aggregation of metric measurements, keyed by instrument
+// name and attribute set. Each instrument holds at most `cardinality_limit`
+// series; measurements for new attribute sets beyond that are folded into a
+// single `otel.metric.overflow=true` series as described in the metrics SDK
+// specification.
+class MetricAggregator {
+public:
+	enum MetricType {
+		METRIC_TYPE_GAUGE = 0,
+		METRIC_TYPE_COUNTER = 1,
+		METRIC_TYPE_UP_DOWN_COUNTER = 2,
+		METRIC_TYPE_HISTOGRAM = 3,
+		METRIC_TYPE_SKETCH = 4,
+	};
+
+	// Values match AggregationTemporality in the OTLP metrics proto.
+	enum Temporality {
+		TEMPORALITY_DELTA = 1,
+		TEMPORALITY_CUMULATIVE = 2,
+	};
+
+	enum ExemplarFilter {
+		EXEMPLAR_FILTER_ALWAYS_OFF = 0,
+		EXEMPLAR_FILTER_ALWAYS_ON = 1,
+		EXEMPLAR_FILTER_TRACE_BASED = 2,
+	};
+
+	static const int DEFAULT_CARDINALITY_LIMIT = 2000;
+	static const int DEFAULT_EXEMPLAR_RESERVOIR_SIZE = 1;
+	static constexpr double DEFAULT_SKETCH_RELATIVE_ACCURACY = 0.01;
+	static const char *OVERFLOW_ATTRIBUTES;
+	static const char *ACTIVE_SERIES_METRIC;
+
+private:
+	struct Series {
+		uint64_t start_time_unix_nano = 0;
+		uint64_t last_time_unix_nano = 0;
+		uint64_t count = 0;
+		double sum = 0.0;
+		double min = 0.0;
+		double max = 0.0;
+		double last = 0.0;
+		std::vector<uint64_t> bucket_counts;
+		DDSketch sketch;
+		// Histograms use an AlignedHistogramBucket reservoir with one slot
+		// per bucket; other instruments use a SimpleFixedSize reservoir.
+		// Offers are counted per collection cycle, like the exemplars.
+		std::vector<MetricExemplar> exemplars;
+		uint64_t exemplar_offers = 0;
+		std::vector<uint64_t> bucket_exemplar_offers;
+	};
+
+	struct Instrument {
+		std::string unit;
+		int type = METRIC_TYPE_GAUGE;
+		int cardinality_limit = DEFAULT_CARDINALITY_LIMIT;
+		int view_cardinality_limit = 0;
+		std::vector<double> bucket_bounds;
+		int sketch_scale = DDSketch::DEFAULT_SCALE;
+		int sketch_max_buckets = DDSketch::DEFAULT_MAX_BUCKETS;
+		std::unordered_map<std::string, Series> series;
+	};
+
+	std::mutex mutex;
+	std::unordered_map<std::string, Instrument> instruments;
+	// Series of all instruments, readable without taking `mutex`.
+	std::atomic<size_t> total_series_count{ 0 };
+	std::unordered_map<std::string, int> cardinality_limits;
+	int default_cardinality_limit = DEFAULT_CARDINALITY_LIMIT;
+	int temporality = TEMPORALITY_DELTA;
+	bool self_metrics_enabled = true;
+	int exemplar_filter = EXEMPLAR_FILTER_TRACE_BASED;
+	int exemplar_reservoir_size = DEFAULT_EXEMPLAR_RESERVOIR_SIZE;
+	int sketch_scale = DDSketch::scale_for_relative_accuracy(DEFAULT_SKETCH_RELATIVE_ACCURACY);
+	int sketch_max_buckets = DDSketch::DEFAULT_MAX_BUCKETS;
+	std::vector<double> sketch_quantiles = { 0.5, 0.9, 0.95, 0.99 };
+	uint64_t random_state = 0x9E3779B97F4A7C15ULL;
+
+	static const std::vector<double> &default_bucket_bounds();
+	static void store_exemplar(MetricExemplar &r_exemplar, double p_value, uint64_t p_time_unix_nano, const SpanContext *p_span_context);
+	size_t record_into(Series &r_series, const Instrument &p_instrument, double p_value, uint64_t p_time_unix_nano);
+	void offer_exemplar(Series &r_series, const Instrument &p_instrument, size_t p_bucket, double p_value, uint64_t p_time_unix_nano, const SpanContext *p_span_context);
+	uint64_t next_random(uint64_t p_bound);
+	static std::string escape_json(const std::string &p_string);
+
+	MetricPoint make_point(const std::string &p_name, const Instrument &p_instrument, const std::string &p_attributes, const Series &p_series, uint64_t p_time_unix_nano) const;
+	MetricPoint make_active_series_point(const std::string &p_name, const Instrument &p_instrument, uint64_t p_time_unix_nano) const;
+	Instrument &get_or_create_instrument(const MetricStream &p_stream, const std::string &p_unit);
+	int resolve_cardinality_limit(const std::string &p_name, const Instrument &p_instrument) const;
+
+public:
+	void record(const MetricStream &p_stream, const std::string &p_unit, const std::string &p_attributes, double p_value, uint64_t p_time_unix_nano, const SpanContext *p_span_context = nullptr);
+	void collect(uint64_t p_time_unix_nano, std::vector<MetricPoint> &r_points);
+	void get_instrument_names(std::vector<std::string> &r_names);
+	void snapshot(const std::string &p_name, uint64_t p_time_unix_nano, std::vector<MetricPoint> &r_points);
+	void clear();
+
+	void set_temporality(int p_temporality);
+	int get_temporality();
+	void set_default_cardinality_limit(int p_limit);
+	void set_cardinality_limit(const std::string &p_name, int p_limit);
+	void set_self_metrics_enabled(bool p_enabled);
+	void set_exemplar_filter(int p_filter);
+	void set_exemplar_reservoir_size(int p_size);
+	void set_sketch_relative_accuracy(double p_relative_accuracy);
+	void set_sketch_max_buckets(int p_max_buckets);
+	void set_sketch_quantiles(const std::vector<double> &p_quantiles);
+	size_t get_series_count(const std::string &p_name);
+	size_t get_total_series_count() const { return total_series_count.load(std::memory_order_relaxed); }
+};
+
+} // namespace godot
+
+#endif // METRIC_AGGREGATOR_H
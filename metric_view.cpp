@@ -0,0 +1,138 @@
+/**************************************************************************/
+/*  metric_view.cpp                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "metric_view.h"
+
+#include "metric_aggregator.h"
+
+#include <algorithm>
+
+using namespace godot;
+
+bool MetricStream::allows_attribute(const std::string &p_key) const {
+	if (!filter_attributes) {
+		return true;
+	}
+	return std::find(attribute_keys.begin(), attribute_keys.end(), p_key) != attribute_keys.end();
+}
+
+bool MetricViewRegistry::match_wildcard(const char *p_pattern, const char *p_name) {
+	// Iterative glob match with single-star backtracking.
+	const char *star = nullptr;
+	const char *resume = nullptr;
+	while (*p_name) {
+		if (*p_pattern == '?' || *p_pattern == *p_name) {
+			p_pattern++;
+			p_name++;
+		} else if (*p_pattern == '*') {
+			star = p_pattern++;
+			resume = p_name;
+		} else if (star) {
+			p_pattern = star + 1;
+			p_name = ++resume;
+		} else {
+			return false;
+		}
+	}
+	while (*p_pattern == '*') {
+		p_pattern++;
+	}
+	return *p_pattern == '\0';
+}
+
+std::shared_ptr<const MetricStream> MetricViewRegistry::create_stream(const std::string &p_name, int p_type) const {
+	std::shared_ptr<MetricStream> stream = std::make_shared<MetricStream>();
+	stream->name = p_name;
+	stream->type = p_type;
+
+	for (const MetricView &view : views) {
+		if (view.instrument_type >= 0 && view.instrument_type != p_type) {
+			continue;
+		}
+		if (!match_wildcard(view.instrument_name.c_str(), p_name.c_str())) {
+			continue;
+		}
+
+		if (!view.name.empty()) {
+			stream->name = view.name;
+		}
+		switch (view.aggregation) {
+			case AGGREGATION_DROP:
+				stream->drop = true;
+				break;
+			case AGGREGATION_SUM:
+				stream->type = p_type == MetricAggregator::METRIC_TYPE_UP_DOWN_COUNTER ? p_type : (int)MetricAggregator::METRIC_TYPE_COUNTER;
+				break;
+			case AGGREGATION_LAST_VALUE:
+				stream->type = MetricAggregator::METRIC_TYPE_GAUGE;
+				break;
+			case AGGREGATION_EXPLICIT_BUCKET_HISTOGRAM:
+				stream->type = MetricAggregator::METRIC_TYPE_HISTOGRAM;
+				break;
+			case AGGREGATION_SKETCH:
+				stream->type = MetricAggregator::METRIC_TYPE_SKETCH;
+				break;
+			default:
+				break;
+		}
+		stream->filter_attributes = view.filter_attributes;
+		stream->attribute_keys = view.attribute_keys;
+		stream->has_bucket_bounds = view.has_bucket_bounds;
+		stream->bucket_bounds = view.bucket_bounds;
+		std::sort(stream->bucket_bounds.begin(), stream->bucket_bounds.end());
+		stream->cardinality_limit = view.cardinality_limit;
+		break;
+	}
+	return stream;
+}
+
+void MetricViewRegistry::add_view(const MetricView &p_view) {
+	std::lock_guard<std::mutex> lock(mutex);
+	views.push_back(p_view);
+	// Instruments resolved from now on see the new view.
+	streams.clear();
+}
+
+void MetricViewRegistry::clear() {
+	std::lock_guard<std::mutex> lock(mutex);
+	views.clear();
+	streams.clear();
+}
+
+std::shared_ptr<const MetricStream> MetricViewRegistry::resolve(const std::string &p_name, int p_type) {
+	std::lock_guard<std::mutex> lock(mutex);
+	auto it = streams.find(p_name);
+	if (it != streams.end()) {
+		return it->second;
+	}
+	std::shared_ptr<const MetricStream> stream = create_stream(p_name, p_type);
+	streams.emplace(p_name, stream);
+	return stream;
+}
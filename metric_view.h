@@ -0,0 +1,99 @@
+/**************************************************************************/
+/*  metric_view.h                                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef METRIC_VIEW_H
+#define METRIC_VIEW_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace godot {
+
+// The resolved output of an instrument after views have been applied. It is
+// computed once per instrument name and shared by every later measurement.
+struct MetricStream {
+	std::string name;
+	int type = 0;
+	bool drop = false;
+	bool filter_attributes = false;
+	std::vector<std::string> attribute_keys;
+	bool has_bucket_bounds = false;
+	std::vector<double> bucket_bounds;
+	int cardinality_limit = 0; // 0 uses the aggregator's limit.
+
+	bool allows_attribute(const std::string &p_key) const;
+};
+
+struct MetricView {
+	std::string instrument_name; // Exact name or wildcard with `*` and `?`.
+	int instrument_type = -1; // -1 matches any instrument type.
+	std::string name; // Empty keeps the instrument name.
+	int aggregation = 0;
+	bool filter_attributes = false;
+	std::vector<std::string> attribute_keys;
+	bool has_bucket_bounds = false;
+	std::vector<double> bucket_bounds;
+	int cardinality_limit = 0;
+};
+
+// Registry of metric views as described in the metrics SDK specification.
+// The first registered view that matches an instrument decides its stream.
+class MetricViewRegistry {
+public:
+	enum Aggregation {
+		AGGREGATION_DEFAULT = 0,
+		AGGREGATION_DROP = 1,
+		AGGREGATION_SUM = 2,
+		AGGREGATION_LAST_VALUE = 3,
+		AGGREGATION_EXPLICIT_BUCKET_HISTOGRAM = 4,
+		AGGREGATION_SKETCH = 5,
+	};
+
+private:
+	std::mutex mutex;
+	std::vector<MetricView> views;
+	std::unordered_map<std::string, std::shared_ptr<const MetricStream>> streams;
+
+	std::shared_ptr<const MetricStream> create_stream(const std::string &p_name, int p_type) const;
+
+public:
+	static bool match_wildcard(const char *p_pattern, const char *p_name);
+
+	void add_view(const MetricView &p_view);
+	void clear();
+	std::shared_ptr<const MetricStream> resolve(const std::string &p_name, int p_type);
+};
+
+} // namespace godot
+
+#endif // METRIC_VIEW_H
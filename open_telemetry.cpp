@@ -30,26 +30,161 @@
 
 #include "open_telemetry.h"
 
+#include "openmetrics_writer.h"
+
 #include <godot_cpp/variant/char_string.hpp>
 #include <godot_cpp/classes/crypto.hpp>
 #include <godot_cpp/classes/json.hpp>
 #include <godot_cpp/classes/time.hpp>
 #include <godot_cpp/classes/http_client.hpp>
 #include <godot_cpp/classes/tls_options.hpp>
+#include <godot_cpp/classes/engine.hpp>
+#include <godot_cpp/classes/engine_debugger.hpp>
+#include <godot_cpp/classes/os.hpp>
+#include <godot_cpp/classes/scene_tree.hpp>
+#include <godot_cpp/variant/callable_method_pointer.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
 #include <vector>
 #include <string>
 
 using namespace godot;
 
+// Called by the engine logger on the thread that logged.
+static bool get_active_span_context(SpanContext &r_context) {
+	const SpanContext *context = ActiveSpanStack::get_current_context();
+	if (!context) {
+		return false;
+	}
+	r_context = *context;
+	return true;
+}
+
+// Binary trace context columns of the logs table, NULL for records
+// logged outside of a span. Span ids use the 8 byte W3C form.
+struct LogContextColumns {
+	duckdb::Value trace_id = duckdb::Value(duckdb::LogicalType::BLOB);
+	duckdb::Value span_id = duckdb::Value(duckdb::LogicalType::BLOB);
+	duckdb::Value flags = duckdb::Value::INTEGER(0);
+};
+
+static LogContextColumns make_log_context_columns(const SpanContext &p_context) {
+	LogContextColumns columns;
+	uint8_t binary[TraceContextPropagator::BINARY_LENGTH];
+	if (p_context.is_valid() && TraceContextPropagator::inject_binary(p_context, binary)) {
+		const int trace_id_size = TraceContextPropagator::TRACE_ID_LENGTH / 2;
+		const int span_id_size = TraceContextPropagator::SPAN_ID_LENGTH / 2;
+		columns.trace_id = duckdb::Value::BLOB(binary, trace_id_size);
+		columns.span_id = duckdb::Value::BLOB(binary + trace_id_size, span_id_size);
+		columns.flags = duckdb::Value::INTEGER(binary[trace_id_size + span_id_size]);
+	}
+	return columns;
+}
+
+static String log_context_id_to_hex(const duckdb::Value &p_value) {
+	static const char *digits = "0123456789abcdef";
+	const std::string &bytes = duckdb::StringValue::Get(p_value);
+	std::string hex;
+	hex.reserve(bytes.size() * 2);
+	for (unsigned char byte : bytes) {
+		hex += digits[byte >> 4];
+		hex += digits[byte & 0xf];
+	}
+	return String(hex.c_str());
+}
+
+// OTLP/JSON encodes 64 bit integers as decimal strings.
+static String otlp_uint64(uint64_t p_value) {
+	return String::num_uint64(p_value);
+}
+
+static Array make_otlp_attributes(const Dictionary &p_attributes);
+
+// An OTLP AnyValue for an attribute value. Attributes are buffered as JSON,
+// which has a single number type, so integral numbers become intValue.
+static Dictionary make_otlp_any_value(const Variant &p_value) {
+	Dictionary any_value;
+	switch (p_value.get_type()) {
+		case Variant::BOOL:
+			any_value["boolValue"] = (bool)p_value;
+			break;
+		case Variant::INT:
+			any_value["intValue"] = String::num_int64((int64_t)p_value);
+			break;
+		case Variant::FLOAT: {
+			double value = p_value;
+			if (std::trunc(value) == value && std::fabs(value) < 9.2e18) {
+				any_value["intValue"] = String::num_int64((int64_t)value);
+			} else {
+				any_value["doubleValue"] = value;
+			}
+		} break;
+		case Variant::DICTIONARY: {
+			Dictionary kvlist;
+			kvlist["values"] = make_otlp_attributes(p_value);
+			any_value["kvlistValue"] = kvlist;
+		} break;
+		case Variant::ARRAY: {
+			Array items = p_value;
+			Array values;
+			for (const Variant &item : items) {
+				values.push_back(make_otlp_any_value(item));
+			}
+			Dictionary array;
+			array["values"] = values;
+			any_value["arrayValue"] = array;
+		} break;
+		default:
+			any_value["stringValue"] = p_value.stringify();
+			break;
+	}
+	return any_value;
+}
+
+// OTLP attributes are a list of KeyValue pairs rather than an object.
+static Array make_otlp_attributes(const Dictionary &p_attributes) {
+	Array attributes;
+	for (const Variant &key : p_attributes.keys()) {
+		Dictionary key_value;
+		key_value["key"] = String(key);
+		key_value["value"] = make_otlp_any_value(p_attributes[key]);
+		attributes.push_back(key_value);
+	}
+	return attributes;
+}
+
 OpenTelemetry::OpenTelemetry() {
 	hostname = String("https://otel.logflare.app:443");
 	flush_interval_ms = 5000;
 	batch_size = 10;
 	last_flush_time = 0;
+	engine_metric_groups = 0;
+	prometheus_previous_temporality = MetricAggregator::TEMPORALITY_DELTA;
+	baggage_span_attributes = false;
+	frame_profiler_spans = true;
+	frame_profiler_metrics = true;
+	head_sampler = std::make_shared<ParentBasedSampler>(std::make_shared<AlwaysOnSampler>());
+	sampler = head_sampler;
+	overhead_sampler = std::make_shared<TraceIdRatioBasedSampler>(0.1);
+	non_recording_span_id = String("00000000-0000-0000-0000-000000000000");
+	otlp_exporter.set_export_callback([this](const OtlpHttpExporter::Batch &p_batch, const OtlpHttpExporter::Response &p_response, uint64_t p_duration_usec, bool p_retry) {
+		RecordExport(p_batch, p_response, p_duration_usec, p_retry);
+	});
+	min_log_severity.store(LogSeverity::SEVERITY_UNSPECIFIED);
+	has_logger_min_log_severities.store(false);
 }
 
 OpenTelemetry::~OpenTelemetry() {
-	// Cleanup (similar to Shutdown but without return value)
+	// Cleanup (similar to Shutdown but without return value). The export
+	// thread reports into members destroyed before the exporter, so it is
+	// stopped first.
+	otlp_exporter.close();
+	DisableFrameProfiler();
+	CaptureEngineLogs(false, false);
+	insert_log_statement.reset();
 	if (conn) {
 		conn.reset();
 	}
@@ -62,17 +197,113 @@ void OpenTelemetry::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("init_tracer_provider", "name", "host", "attributes"), &OpenTelemetry::init_tracer_provider);
 	ClassDB::bind_method(D_METHOD("set_headers", "headers"), &OpenTelemetry::set_headers);
 	ClassDB::bind_method(D_METHOD("start_span", "name"), &OpenTelemetry::start_span);
+	ClassDB::bind_method(D_METHOD("start_root_span", "name"), &OpenTelemetry::start_root_span);
 	ClassDB::bind_method(D_METHOD("start_span_with_parent", "name", "parent_span_uuid"), &OpenTelemetry::start_span_with_parent);
+	ClassDB::bind_method(D_METHOD("activate", "span_uuid"), &OpenTelemetry::activate);
+	ClassDB::bind_method(D_METHOD("deactivate"), &OpenTelemetry::deactivate);
+	ClassDB::bind_method(D_METHOD("get_current_span"), &OpenTelemetry::get_current_span);
+	ClassDB::bind_method(D_METHOD("activate_scope", "span_uuid"), &OpenTelemetry::activate_scope);
+	ClassDB::bind_method(D_METHOD("start_span_with_context", "name", "context"), &OpenTelemetry::start_span_with_context);
+	ClassDB::bind_method(D_METHOD("inject", "span_uuid", "headers"), &OpenTelemetry::inject);
+	ClassDB::bind_method(D_METHOD("extract", "headers"), &OpenTelemetry::extract);
+	ClassDB::bind_method(D_METHOD("inject_binary", "span_uuid"), &OpenTelemetry::inject_binary);
+	ClassDB::bind_method(D_METHOD("start_span_with_binary_context", "name", "context"), &OpenTelemetry::start_span_with_binary_context);
+	ClassDB::bind_method(D_METHOD("set_baggage", "span_uuid", "name", "value", "metadata"), &OpenTelemetry::set_baggage, DEFVAL(""));
+	ClassDB::bind_method(D_METHOD("get_baggage", "span_uuid", "name"), &OpenTelemetry::get_baggage);
+	ClassDB::bind_method(D_METHOD("get_all_baggage", "span_uuid"), &OpenTelemetry::get_all_baggage);
+	ClassDB::bind_method(D_METHOD("remove_baggage", "span_uuid", "name"), &OpenTelemetry::remove_baggage);
+	ClassDB::bind_method(D_METHOD("set_baggage_span_attributes", "enabled", "keys"), &OpenTelemetry::set_baggage_span_attributes, DEFVAL(PackedStringArray()));
+	ClassDB::bind_method(D_METHOD("set_sampler", "sampler", "ratio"), &OpenTelemetry::set_sampler, DEFVAL(1.0));
+	ClassDB::bind_method(D_METHOD("set_span_rate_limit", "spans_per_second", "burst"), &OpenTelemetry::set_span_rate_limit, DEFVAL(0));
+	ClassDB::bind_method(D_METHOD("is_recording", "span_uuid"), &OpenTelemetry::is_recording);
+	ClassDB::bind_method(D_METHOD("get_trace_state", "span_uuid"), &OpenTelemetry::get_trace_state);
+	ClassDB::bind_static_method("OpenTelemetry", D_METHOD("get_adjusted_count", "trace_state"), &OpenTelemetry::get_adjusted_count);
+	ClassDB::bind_method(D_METHOD("enable_tail_sampling", "policy"), &OpenTelemetry::enable_tail_sampling);
+	ClassDB::bind_method(D_METHOD("disable_tail_sampling"), &OpenTelemetry::disable_tail_sampling);
+	ClassDB::bind_method(D_METHOD("generate_uuid_v7"), &OpenTelemetry::generate_uuid_v7);
 	ClassDB::bind_method(D_METHOD("add_event", "span_uuid", "event_name"), &OpenTelemetry::add_event);
 	ClassDB::bind_method(D_METHOD("set_attributes", "span_uuid", "attributes"), &OpenTelemetry::set_attributes);
 	ClassDB::bind_method(D_METHOD("record_error", "span_uuid", "err"), &OpenTelemetry::record_error);
 	ClassDB::bind_method(D_METHOD("end_span", "span_uuid"), &OpenTelemetry::end_span);
 	ClassDB::bind_method(D_METHOD("set_flush_interval", "interval_ms"), &OpenTelemetry::set_flush_interval);
 	ClassDB::bind_method(D_METHOD("set_batch_size", "size"), &OpenTelemetry::set_batch_size);
+	ClassDB::bind_method(D_METHOD("set_export_timeout", "timeout_ms"), &OpenTelemetry::set_export_timeout);
 	ClassDB::bind_method(D_METHOD("record_metric", "name", "value", "unit", "metric_type", "attributes"), &OpenTelemetry::record_metric);
-	ClassDB::bind_method(D_METHOD("log_message", "level", "message", "attributes"), &OpenTelemetry::log_message);
+	ClassDB::bind_method(D_METHOD("set_metric_temporality", "temporality"), &OpenTelemetry::set_metric_temporality);
+	ClassDB::bind_method(D_METHOD("set_cardinality_limit", "limit"), &OpenTelemetry::set_cardinality_limit);
+	ClassDB::bind_method(D_METHOD("set_instrument_cardinality_limit", "name", "limit"), &OpenTelemetry::set_instrument_cardinality_limit);
+	ClassDB::bind_method(D_METHOD("set_exemplar_filter", "filter"), &OpenTelemetry::set_exemplar_filter);
+	ClassDB::bind_method(D_METHOD("set_exemplar_reservoir_size", "size"), &OpenTelemetry::set_exemplar_reservoir_size);
+	ClassDB::bind_method(D_METHOD("set_sketch_relative_accuracy", "relative_accuracy"), &OpenTelemetry::set_sketch_relative_accuracy);
+	ClassDB::bind_method(D_METHOD("set_sketch_max_buckets", "max_buckets"), &OpenTelemetry::set_sketch_max_buckets);
+	ClassDB::bind_method(D_METHOD("set_sketch_quantiles", "quantiles"), &OpenTelemetry::set_sketch_quantiles);
+	ClassDB::bind_method(D_METHOD("add_metric_view", "instrument_name", "view"), &OpenTelemetry::add_metric_view);
+	ClassDB::bind_method(D_METHOD("clear_metric_views"), &OpenTelemetry::clear_metric_views);
+	ClassDB::bind_method(D_METHOD("set_engine_metrics", "groups"), &OpenTelemetry::set_engine_metrics);
+	ClassDB::bind_method(D_METHOD("start_prometheus_exporter", "port", "bind_address"), &OpenTelemetry::start_prometheus_exporter, DEFVAL("127.0.0.1"));
+	ClassDB::bind_method(D_METHOD("stop_prometheus_exporter"), &OpenTelemetry::stop_prometheus_exporter);
+	ClassDB::bind_method(D_METHOD("enable_frame_profiler", "options"), &OpenTelemetry::enable_frame_profiler, DEFVAL(Dictionary()));
+	ClassDB::bind_method(D_METHOD("disable_frame_profiler"), &OpenTelemetry::disable_frame_profiler);
+	ClassDB::bind_method(D_METHOD("log_message", "level", "message", "attributes", "span_uuid"), &OpenTelemetry::log_message, DEFVAL(""));
+	ClassDB::bind_method(D_METHOD("log_template", "level", "template", "args", "attributes", "span_uuid"), &OpenTelemetry::log_template, DEFVAL(Array()), DEFVAL(Dictionary()), DEFVAL(""));
+	ClassDB::bind_method(D_METHOD("emit_log", "severity", "message", "attributes", "logger_name", "span_uuid"), &OpenTelemetry::emit_log, DEFVAL(Dictionary()), DEFVAL(""), DEFVAL(""));
+	ClassDB::bind_method(D_METHOD("set_log_deduplication", "window_sec", "records_per_second", "burst"), &OpenTelemetry::set_log_deduplication, DEFVAL(0.0), DEFVAL(1));
+	ClassDB::bind_method(D_METHOD("is_log_enabled", "severity", "logger_name"), &OpenTelemetry::is_log_enabled, DEFVAL(""));
+	ClassDB::bind_method(D_METHOD("set_min_log_severity", "severity", "logger_name"), &OpenTelemetry::set_min_log_severity, DEFVAL(""));
+	ClassDB::bind_method(D_METHOD("get_min_log_severity", "logger_name"), &OpenTelemetry::get_min_log_severity, DEFVAL(""));
+	ClassDB::bind_method(D_METHOD("capture_engine_logs", "enabled", "include_print"), &OpenTelemetry::capture_engine_logs, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("set_overhead_budget", "budget_ms", "sampling_ratio"), &OpenTelemetry::set_overhead_budget, DEFVAL(0.1));
+	ClassDB::bind_method(D_METHOD("get_degradation_level"), &OpenTelemetry::get_degradation_level);
+	ClassDB::bind_method(D_METHOD("get_stats"), &OpenTelemetry::get_stats);
 	ClassDB::bind_method(D_METHOD("flush_all"), &OpenTelemetry::flush_all);
 	ClassDB::bind_method(D_METHOD("shutdown"), &OpenTelemetry::shutdown);
+
+	BIND_ENUM_CONSTANT(METRIC_TYPE_GAUGE);
+	BIND_ENUM_CONSTANT(METRIC_TYPE_COUNTER);
+	BIND_ENUM_CONSTANT(METRIC_TYPE_UP_DOWN_COUNTER);
+	BIND_ENUM_CONSTANT(METRIC_TYPE_HISTOGRAM);
+	BIND_ENUM_CONSTANT(METRIC_TYPE_SKETCH);
+
+	BIND_ENUM_CONSTANT(METRIC_TEMPORALITY_DELTA);
+	BIND_ENUM_CONSTANT(METRIC_TEMPORALITY_CUMULATIVE);
+
+	BIND_ENUM_CONSTANT(EXEMPLAR_FILTER_ALWAYS_OFF);
+	BIND_ENUM_CONSTANT(EXEMPLAR_FILTER_ALWAYS_ON);
+	BIND_ENUM_CONSTANT(EXEMPLAR_FILTER_TRACE_BASED);
+
+	BIND_ENUM_CONSTANT(METRIC_AGGREGATION_DEFAULT);
+	BIND_ENUM_CONSTANT(METRIC_AGGREGATION_DROP);
+	BIND_ENUM_CONSTANT(METRIC_AGGREGATION_SUM);
+	BIND_ENUM_CONSTANT(METRIC_AGGREGATION_LAST_VALUE);
+	BIND_ENUM_CONSTANT(METRIC_AGGREGATION_EXPLICIT_BUCKET_HISTOGRAM);
+	BIND_ENUM_CONSTANT(METRIC_AGGREGATION_SKETCH);
+
+	BIND_ENUM_CONSTANT(ENGINE_METRICS_TIME);
+	BIND_ENUM_CONSTANT(ENGINE_METRICS_MEMORY);
+	BIND_ENUM_CONSTANT(ENGINE_METRICS_OBJECTS);
+	BIND_ENUM_CONSTANT(ENGINE_METRICS_RENDER);
+	BIND_ENUM_CONSTANT(ENGINE_METRICS_PHYSICS);
+	BIND_ENUM_CONSTANT(ENGINE_METRICS_NAVIGATION);
+
+	BIND_ENUM_CONSTANT(SAMPLER_ALWAYS_ON);
+	BIND_ENUM_CONSTANT(SAMPLER_ALWAYS_OFF);
+	BIND_ENUM_CONSTANT(SAMPLER_TRACE_ID_RATIO);
+	BIND_ENUM_CONSTANT(SAMPLER_PARENT_BASED_ALWAYS_ON);
+	BIND_ENUM_CONSTANT(SAMPLER_PARENT_BASED_ALWAYS_OFF);
+	BIND_ENUM_CONSTANT(SAMPLER_PARENT_BASED_TRACE_ID_RATIO);
+
+	BIND_ENUM_CONSTANT(LOG_SEVERITY_UNSPECIFIED);
+	BIND_ENUM_CONSTANT(LOG_SEVERITY_TRACE);
+	BIND_ENUM_CONSTANT(LOG_SEVERITY_DEBUG);
+	BIND_ENUM_CONSTANT(LOG_SEVERITY_INFO);
+	BIND_ENUM_CONSTANT(LOG_SEVERITY_WARN);
+	BIND_ENUM_CONSTANT(LOG_SEVERITY_ERROR);
+	BIND_ENUM_CONSTANT(LOG_SEVERITY_FATAL);
+
+	BIND_ENUM_CONSTANT(DEGRADATION_NONE);
+	BIND_ENUM_CONSTANT(DEGRADATION_NO_DEBUG_LOGS);
+	BIND_ENUM_CONSTANT(DEGRADATION_AGGREGATED_METRICS);
+	BIND_ENUM_CONSTANT(DEGRADATION_SAMPLED_TRACES);
 }
 
 String OpenTelemetry::init_tracer_provider(String p_name, String p_host, Dictionary p_attributes) {
@@ -96,13 +327,252 @@ String OpenTelemetry::set_headers(Dictionary p_headers) {
 }
 
 String OpenTelemetry::start_span(String p_name) {
+	OverheadBudget::Scope overhead(overhead_budget);
+	// The span active on this thread, if any, is the implicit parent.
+	const String &current = ActiveSpanStack::get_current();
+	if (!current.is_empty()) {
+		return start_span_with_parent(p_name, current);
+	}
+	return start_root_span(p_name);
+}
+
+String OpenTelemetry::start_root_span(String p_name) {
+	OverheadBudget::Scope overhead(overhead_budget);
+	CharString c_name = p_name.utf8();
+	String trace_id = GenerateTraceId();
+	Sampler::Result sampling = ShouldSample(nullptr, trace_id, c_name.get_data());
+	if (sampling.decision == Sampler::DECISION_DROP) {
+		return non_recording_span_id;
+	}
 	String span_id = generate_uuid_v7();
-	return start_span_with_id(p_name, span_id);
+	return start_span_with_id(p_name, span_id, trace_id, sampling.trace_state);
 }
 
 String OpenTelemetry::start_span_with_parent(String p_name, String p_parent_span_uuid) {
+	OverheadBudget::Scope overhead(overhead_budget);
+	// Only sampled spans get real ids, so any other handle is a sampled
+	// parent. Children join their parent's trace. A parent that is not
+	// recording is passed on unsampled; one that is no longer known leaves
+	// the child to start a new trace as a root span.
+	SpanContext parent;
+	parent.sampled = p_parent_span_uuid != non_recording_span_id;
+	bool has_parent = !parent.sampled || GetParentContext(p_parent_span_uuid, parent);
+	String trace_id = parent.trace_id.empty() ? GenerateTraceId() : String(parent.trace_id.c_str());
+	CharString c_name = p_name.utf8();
+	Sampler::Result sampling = ShouldSample(has_parent ? &parent : nullptr, trace_id, c_name.get_data());
+	if (sampling.decision == Sampler::DECISION_DROP) {
+		return non_recording_span_id;
+	}
 	String span_id = generate_uuid_v7();
-	return start_span_with_parent_id(p_name, p_parent_span_uuid, span_id);
+	String result = parent.trace_id.empty()
+			? start_span_with_id(p_name, span_id, trace_id, sampling.trace_state)
+			: start_span_with_parent_id(p_name, p_parent_span_uuid, span_id, trace_id, sampling.trace_state);
+	SetBaggage(span_id.utf8().get_data(), GetBaggage(p_parent_span_uuid.utf8().get_data()));
+	return result;
+}
+
+void OpenTelemetry::activate(String p_span_uuid) {
+	ActiveSpanStack::push(p_span_uuid, GetSpanContext(p_span_uuid));
+}
+
+void OpenTelemetry::deactivate() {
+	ActiveSpanStack::pop();
+}
+
+String OpenTelemetry::get_current_span() {
+	return ActiveSpanStack::get_current();
+}
+
+Ref<OpenTelemetryScope> OpenTelemetry::activate_scope(String p_span_uuid) {
+	Ref<OpenTelemetryScope> scope;
+	scope.instantiate();
+	scope->open_scope(p_span_uuid, GetSpanContext(p_span_uuid));
+	return scope;
+}
+
+String OpenTelemetry::start_span_with_context(String p_name, Dictionary p_context) {
+	OverheadBudget::Scope overhead(overhead_budget);
+	String span_id;
+	if (!p_context.has("trace_id") || !p_context.has("span_id")) {
+		span_id = start_span(p_name);
+	} else {
+		SpanContext parent;
+		parent.trace_id = String(p_context["trace_id"]).utf8().get_data();
+		parent.span_id = String(p_context["span_id"]).utf8().get_data();
+		parent.trace_state = String(p_context.get("trace_state", String())).utf8().get_data();
+		parent.sampled = p_context.get("sampled", true);
+		parent.is_remote = true;
+		span_id = StartSpanWithRemoteParent(p_name, parent);
+	}
+
+	if (p_context.has("baggage") && span_id != non_recording_span_id) {
+		Dictionary entries = p_context["baggage"];
+		Baggage baggage;
+		for (const Variant &name : entries.keys()) {
+			baggage = baggage.set_value(String(name).utf8().get_data(), String(entries[name]).utf8().get_data());
+		}
+		SetBaggage(span_id.utf8().get_data(), baggage);
+	}
+	return span_id;
+}
+
+PackedByteArray OpenTelemetry::inject_binary(String p_span_uuid) {
+	PackedByteArray context;
+	SpanContext span_context;
+	if (p_span_uuid == non_recording_span_id || !GetParentContext(p_span_uuid, span_context)) {
+		return context;
+	}
+	span_context.span_id = p_span_uuid.utf8().get_data();
+	context.resize(TraceContextPropagator::BINARY_LENGTH);
+	if (!TraceContextPropagator::inject_binary(span_context, context.ptrw())) {
+		context.clear();
+	}
+	return context;
+}
+
+String OpenTelemetry::start_span_with_binary_context(String p_name, PackedByteArray p_context) {
+	OverheadBudget::Scope overhead(overhead_budget);
+	SpanContext parent;
+	if (!TraceContextPropagator::extract_binary(p_context.ptr(), p_context.size(), parent)) {
+		return start_span(p_name);
+	}
+	return StartSpanWithRemoteParent(p_name, parent);
+}
+
+// Matches a `Name: value` header line case-insensitively and returns the
+// value without copying it.
+static bool match_header(const CharString &p_line, const char *p_name, const char *&r_value, size_t &r_length) {
+	const char *line = p_line.get_data();
+	size_t name_length = strlen(p_name);
+	if ((size_t)p_line.length() <= name_length || line[name_length] != ':') {
+		return false;
+	}
+	for (size_t i = 0; i < name_length; i++) {
+		if (tolower((unsigned char)line[i]) != p_name[i]) {
+			return false;
+		}
+	}
+	r_value = line + name_length + 1;
+	r_length = p_line.length() - name_length - 1;
+	return true;
+}
+
+PackedStringArray OpenTelemetry::inject(String p_span_uuid, PackedStringArray p_headers) {
+	SpanContext context;
+	if (p_span_uuid == non_recording_span_id || !GetParentContext(p_span_uuid, context)) {
+		return p_headers;
+	}
+	context.span_id = p_span_uuid.utf8().get_data();
+	char traceparent[TraceContextPropagator::TRACEPARENT_LENGTH + 1];
+	if (!TraceContextPropagator::inject_traceparent(context, traceparent)) {
+		return p_headers;
+	}
+
+	// Replace any context a previous inject() left in the carrier.
+	PackedStringArray headers;
+	const char *value;
+	size_t length;
+	for (const String &header : p_headers) {
+		CharString line = header.utf8();
+		if (!match_header(line, TraceContextPropagator::TRACEPARENT_HEADER, value, length) &&
+				!match_header(line, TraceContextPropagator::TRACESTATE_HEADER, value, length) &&
+				!match_header(line, Baggage::HEADER, value, length)) {
+			headers.push_back(header);
+		}
+	}
+	headers.push_back(String(TraceContextPropagator::TRACEPARENT_HEADER) + ": " + traceparent);
+	if (!context.trace_state.empty()) {
+		headers.push_back(String(TraceContextPropagator::TRACESTATE_HEADER) + ": " + String::utf8(context.trace_state.c_str()));
+	}
+	std::string baggage = GetBaggage(context.span_id).to_header();
+	if (!baggage.empty()) {
+		headers.push_back(String(Baggage::HEADER) + ": " + String::utf8(baggage.c_str()));
+	}
+	return headers;
+}
+
+Dictionary OpenTelemetry::extract(PackedStringArray p_headers) {
+	SpanContext context;
+	bool found = false;
+	std::string trace_state;
+	std::string baggage_header;
+	const char *value;
+	size_t length;
+	for (const String &header : p_headers) {
+		CharString line = header.utf8();
+		if (match_header(line, TraceContextPropagator::TRACEPARENT_HEADER, value, length)) {
+			found = TraceContextPropagator::extract_traceparent(value, length, context);
+		} else if (match_header(line, TraceContextPropagator::TRACESTATE_HEADER, value, length)) {
+			// Repeated tracestate headers form one list.
+			if (!trace_state.empty()) {
+				trace_state += ',';
+			}
+			trace_state.append(value, length);
+		} else if (match_header(line, Baggage::HEADER, value, length)) {
+			if (!baggage_header.empty()) {
+				baggage_header += ',';
+			}
+			baggage_header.append(value, length);
+		}
+	}
+
+	// Baggage is propagated independently of the trace context.
+	Dictionary result;
+	if (!baggage_header.empty()) {
+		std::vector<Baggage::Entry> entries;
+		Baggage::from_header(baggage_header.data(), baggage_header.size()).get_all(entries);
+		Dictionary baggage;
+		for (const Baggage::Entry &entry : entries) {
+			baggage[String::utf8(entry.name.c_str())] = String::utf8(entry.value.c_str());
+		}
+		result["baggage"] = baggage;
+	}
+	if (!found) {
+		// Without a valid traceparent the tracestate must be discarded too.
+		return result;
+	}
+	result["trace_id"] = String(context.trace_id.c_str());
+	result["span_id"] = String(context.span_id.c_str());
+	result["sampled"] = context.sampled;
+	result["trace_state"] = String::utf8(TraceContextPropagator::extract_trace_state(trace_state.data(), trace_state.size()).c_str());
+	return result;
+}
+
+void OpenTelemetry::set_baggage(String p_span_uuid, String p_name, String p_value, String p_metadata) {
+	if (!active_spans.has(p_span_uuid)) {
+		return;
+	}
+	std::string span_id = p_span_uuid.utf8().get_data();
+	SetBaggage(span_id, GetBaggage(span_id).set_value(p_name.utf8().get_data(), p_value.utf8().get_data(), p_metadata.utf8().get_data()));
+}
+
+String OpenTelemetry::get_baggage(String p_span_uuid, String p_name) {
+	std::string value;
+	GetBaggage(p_span_uuid.utf8().get_data()).get_value(p_name.utf8().get_data(), value);
+	return String::utf8(value.c_str());
+}
+
+Dictionary OpenTelemetry::get_all_baggage(String p_span_uuid) {
+	std::vector<Baggage::Entry> entries;
+	GetBaggage(p_span_uuid.utf8().get_data()).get_all(entries);
+	Dictionary result;
+	for (const Baggage::Entry &entry : entries) {
+		result[String::utf8(entry.name.c_str())] = String::utf8(entry.value.c_str());
+	}
+	return result;
+}
+
+void OpenTelemetry::remove_baggage(String p_span_uuid, String p_name) {
+	std::string span_id = p_span_uuid.utf8().get_data();
+	SetBaggage(span_id, GetBaggage(span_id).remove_value(p_name.utf8().get_data()));
+}
+
+void OpenTelemetry::set_baggage_span_attributes(bool p_enabled, PackedStringArray p_keys) {
+	baggage_span_attributes = p_enabled;
+	baggage_attribute_keys.clear();
+	for (const String &key : p_keys) {
+		baggage_attribute_keys.push_back(key.utf8().get_data());
+	}
 }
 
 String OpenTelemetry::generate_uuid_v7() {
@@ -139,27 +609,82 @@ String OpenTelemetry::generate_uuid_v7() {
 	return String(buffer);
 }
 
-String OpenTelemetry::start_span_with_id(String p_name, String p_span_id) {
+String OpenTelemetry::start_span_with_id(String p_name, String p_span_id, String p_trace_id, const std::string &p_trace_state) {
 	CharString c_name = p_name.utf8();
 	char* cstr_name = c_name.ptrw();
 	CharString c_span_id = p_span_id.utf8();
 	char* cstr_span_id = c_span_id.ptrw();
-	char* result = StartSpanWithId(cstr_name, cstr_span_id);
+	CharString c_trace_id = p_trace_id.utf8();
+	char* result = StartSpanWithId(cstr_name, cstr_span_id, c_trace_id.get_data(), p_trace_state.c_str());
 	return String(result);
 }
 
-String OpenTelemetry::start_span_with_parent_id(String p_name, String p_parent_span_uuid, String p_span_id) {
+String OpenTelemetry::start_span_with_parent_id(String p_name, String p_parent_span_uuid, String p_span_id, String p_trace_id, const std::string &p_trace_state) {
 	CharString c_name = p_name.utf8();
 	char* cstr_name = c_name.ptrw();
 	CharString c_parent_id = p_parent_span_uuid.utf8();
 	char* cstr_parent_id = c_parent_id.ptrw();
 	CharString c_span_id = p_span_id.utf8();
 	char* cstr_span_id = c_span_id.ptrw();
-	char* result = StartSpanWithParentWithId(cstr_name, cstr_parent_id, cstr_span_id);
+	CharString c_trace_id = p_trace_id.utf8();
+	char* result = StartSpanWithParentWithId(cstr_name, cstr_parent_id, cstr_span_id, c_trace_id.get_data(), p_trace_state.c_str());
 	return String(result);
 }
 
+void OpenTelemetry::set_sampler(int p_sampler, double p_ratio) {
+	SetSampler(p_sampler, p_ratio);
+}
+
+void OpenTelemetry::set_span_rate_limit(double p_spans_per_second, int p_burst) {
+	SetSpanRateLimit(p_spans_per_second, p_burst);
+}
+
+bool OpenTelemetry::is_recording(String p_span_uuid) {
+	return p_span_uuid != non_recording_span_id && active_spans.has(p_span_uuid);
+}
+
+String OpenTelemetry::get_trace_state(String p_span_uuid) {
+	if (!active_spans.has(p_span_uuid)) {
+		return String();
+	}
+	Dictionary span = active_spans[p_span_uuid];
+	return span["trace_state"];
+}
+
+double OpenTelemetry::get_adjusted_count(String p_trace_state) {
+	return ConsistentProbability::adjusted_count_for_trace_state(p_trace_state.utf8().get_data());
+}
+
+void OpenTelemetry::enable_tail_sampling(Dictionary p_policy) {
+	TailSampler::Policy policy;
+	policy.decision_wait_ms = p_policy.get("decision_wait_ms", TailSampler::DEFAULT_DECISION_WAIT_MS);
+	policy.max_hold_ms = p_policy.get("max_hold_ms", TailSampler::DEFAULT_MAX_HOLD_MS);
+	policy.latency_threshold_ms = p_policy.get("latency_threshold_ms", 0.0);
+	policy.keep_ratio = p_policy.get("keep_ratio", 0.0);
+
+	// Span attributes are buffered as compact JSON, so each rule becomes the
+	// `"key":value` fragment the same serializer produces, full precision
+	// included.
+	if (p_policy.has("attributes")) {
+		Dictionary attributes = p_policy["attributes"];
+		for (const Variant &key : attributes.keys()) {
+			String match = JSON::stringify(String(key)) + ":" + JSON::stringify(attributes[key], "", true, true);
+			policy.attribute_matches.push_back(match.utf8().get_data());
+		}
+	}
+
+	EnableTailSampling(policy);
+}
+
+void OpenTelemetry::disable_tail_sampling() {
+	DisableTailSampling();
+}
+
 void OpenTelemetry::add_event(String p_span_uuid, String p_event_name) {
+	OverheadBudget::Scope overhead(overhead_budget);
+	if (p_span_uuid == non_recording_span_id) {
+		return;
+	}
 	CharString c_event_id = p_span_uuid.utf8();
 	char *cstr_event_id = c_event_id.ptrw();
 	CharString c_event_name = p_event_name.utf8();
@@ -168,6 +693,10 @@ void OpenTelemetry::add_event(String p_span_uuid, String p_event_name) {
 }
 
 void OpenTelemetry::set_attributes(String p_span_uuid, Dictionary p_attributes) {
+	OverheadBudget::Scope overhead(overhead_budget);
+	if (p_span_uuid == non_recording_span_id) {
+		return;
+	}
 	CharString c_attribute_id = p_span_uuid.utf8();
 	char *cstr_attribute_id = c_attribute_id.ptrw();
 	String json_attributes = JSON::stringify(p_attributes, "", true, true);
@@ -177,6 +706,10 @@ void OpenTelemetry::set_attributes(String p_span_uuid, Dictionary p_attributes)
 }
 
 void OpenTelemetry::record_error(String p_span_uuid, String p_error) {
+	OverheadBudget::Scope overhead(overhead_budget);
+	if (p_span_uuid == non_recording_span_id) {
+		return;
+	}
 	CharString c_error_id = p_span_uuid.utf8();
 	char *cstr_error_id = c_error_id.ptrw();
 	CharString c_error = p_error.utf8();
@@ -185,6 +718,10 @@ void OpenTelemetry::record_error(String p_span_uuid, String p_error) {
 }
 
 void OpenTelemetry::end_span(String p_span_uuid) {
+	OverheadBudget::Scope overhead(overhead_budget);
+	if (p_span_uuid == non_recording_span_id) {
+		return;
+	}
 	CharString c_span_id = p_span_uuid.utf8();
 	char *cstr_span_id = c_span_id.ptrw();
 	EndSpan(cstr_span_id);
@@ -194,22 +731,156 @@ void OpenTelemetry::set_flush_interval(int p_interval_ms) {
 	SetFlushInterval(p_interval_ms);
 }
 
+void OpenTelemetry::set_export_timeout(int p_timeout_ms) {
+	std::lock_guard<std::mutex> lock(db_mutex);
+	otlp_exporter.set_timeout(p_timeout_ms);
+}
+
 void OpenTelemetry::set_batch_size(int p_size) {
 	SetBatchSize(p_size);
 }
 
 void OpenTelemetry::record_metric(String p_name, float p_value, String p_unit, int p_metric_type, Dictionary p_attributes) {
+	OverheadBudget::Scope overhead(overhead_budget);
 	CharString c_name = p_name.utf8();
-	char *cstr_name = c_name.ptrw();
-	String json_attributes = JSON::stringify(p_attributes, "", true, true);
+	std::shared_ptr<const MetricStream> stream = metric_views.resolve(std::string(c_name.get_data()), p_metric_type);
+	if (stream->drop) {
+		// Dropped by a view: return before any attribute serialization.
+		return;
+	}
+
+	Dictionary attributes = p_attributes;
+	if (stream->filter_attributes) {
+		attributes = Dictionary();
+		for (const Variant &key : p_attributes.keys()) {
+			if (stream->allows_attribute(std::string(String(key).utf8().get_data()))) {
+				attributes[key] = p_attributes[key];
+			}
+		}
+	}
+
+	String json_attributes = JSON::stringify(attributes, "", true, true);
 	CharString c_json_attributes = json_attributes.utf8();
 	char *cstr_json_attributes = c_json_attributes.ptrw();
 	CharString c_unit = p_unit.utf8();
 	char *cstr_unit = c_unit.ptrw();
-	RecordMetric(cstr_name, (double)p_value, cstr_unit, p_metric_type, cstr_json_attributes);
+	RecordMetric(*stream, (double)p_value, cstr_unit, cstr_json_attributes);
+}
+
+void OpenTelemetry::set_metric_temporality(int p_temporality) {
+	SetMetricTemporality(p_temporality);
+}
+
+void OpenTelemetry::set_cardinality_limit(int p_limit) {
+	SetCardinalityLimit(p_limit);
+}
+
+void OpenTelemetry::set_instrument_cardinality_limit(String p_name, int p_limit) {
+	CharString c_name = p_name.utf8();
+	SetInstrumentCardinalityLimit(c_name.get_data(), p_limit);
+}
+
+void OpenTelemetry::set_exemplar_filter(int p_filter) {
+	SetExemplarFilter(p_filter);
+}
+
+void OpenTelemetry::set_exemplar_reservoir_size(int p_size) {
+	SetExemplarReservoirSize(p_size);
+}
+
+void OpenTelemetry::set_sketch_relative_accuracy(double p_relative_accuracy) {
+	SetSketchRelativeAccuracy(p_relative_accuracy);
+}
+
+void OpenTelemetry::set_sketch_max_buckets(int p_max_buckets) {
+	SetSketchMaxBuckets(p_max_buckets);
+}
+
+void OpenTelemetry::set_sketch_quantiles(Array p_quantiles) {
+	std::vector<double> quantiles;
+	for (int i = 0; i < p_quantiles.size(); i++) {
+		quantiles.push_back((double)p_quantiles[i]);
+	}
+	SetSketchQuantiles(quantiles);
+}
+
+void OpenTelemetry::add_metric_view(String p_instrument_name, Dictionary p_view) {
+	MetricView view;
+	view.instrument_name = p_instrument_name.utf8().get_data();
+	view.instrument_type = p_view.get("instrument_type", -1);
+	view.name = String(p_view.get("name", "")).utf8().get_data();
+	view.aggregation = p_view.get("aggregation", (int)METRIC_AGGREGATION_DEFAULT);
+	view.cardinality_limit = p_view.get("cardinality_limit", 0);
+
+	if (p_view.has("attribute_keys")) {
+		Array attribute_keys = p_view["attribute_keys"];
+		view.filter_attributes = true;
+		for (int i = 0; i < attribute_keys.size(); i++) {
+			view.attribute_keys.push_back(String(attribute_keys[i]).utf8().get_data());
+		}
+	}
+
+	if (p_view.has("bucket_boundaries")) {
+		Array bucket_boundaries = p_view["bucket_boundaries"];
+		view.has_bucket_bounds = true;
+		for (int i = 0; i < bucket_boundaries.size(); i++) {
+			view.bucket_bounds.push_back((double)bucket_boundaries[i]);
+		}
+	}
+
+	AddMetricView(view);
+}
+
+void OpenTelemetry::clear_metric_views() {
+	ClearMetricViews();
 }
 
-void OpenTelemetry::log_message(String p_level, String p_message, Dictionary p_attributes) {
+void OpenTelemetry::set_engine_metrics(int p_groups) {
+	SetEngineMetrics(p_groups);
+}
+
+int OpenTelemetry::start_prometheus_exporter(int p_port, String p_bind_address) {
+	return StartPrometheusExporter(p_port, p_bind_address);
+}
+
+void OpenTelemetry::stop_prometheus_exporter() {
+	StopPrometheusExporter();
+}
+
+int OpenTelemetry::enable_frame_profiler(Dictionary p_options) {
+	EngineDebugger *debugger = EngineDebugger::get_singleton();
+	if (!debugger || !debugger->is_active()) {
+		// The engine only ticks profilers while a debugger session is active.
+		return ERR_UNAVAILABLE;
+	}
+	DisableFrameProfiler();
+
+	frame_profiler_spans = p_options.get("spans", true);
+	frame_profiler_metrics = p_options.get("metrics", true);
+	frame_profiler.instantiate();
+	frame_profiler->set_frame_interval(p_options.get("frame_interval", OpenTelemetryProfiler::DEFAULT_FRAME_INTERVAL));
+	frame_profiler->set_callback([this](const OpenTelemetryProfiler::Frame &frame) { RecordProfilerFrame(frame); });
+	debugger->register_profiler(OpenTelemetryProfiler::PROFILER_NAME, frame_profiler);
+	debugger->profiler_enable(OpenTelemetryProfiler::PROFILER_NAME, true);
+	return OK;
+}
+
+void OpenTelemetry::disable_frame_profiler() {
+	DisableFrameProfiler();
+}
+
+void OpenTelemetry::log_message(String p_level, String p_message, Dictionary p_attributes, String p_span_uuid) {
+	OverheadBudget::Scope overhead(overhead_budget);
+	// Filter on the parsed level before anything is converted or locked.
+	int severity_number = LogSeverity::parse(p_level.ptr(), p_level.length());
+	if (!IsLogEnabled(severity_number, String())) {
+		sdk_metrics.add_dropped(OtlpHttpExporter::SIGNAL_LOGS, SdkMetrics::DROP_SEVERITY);
+		return;
+	}
+	if (IsLogShed(severity_number)) {
+		sdk_metrics.add_dropped(OtlpHttpExporter::SIGNAL_LOGS, SdkMetrics::DROP_OVERHEAD_BUDGET);
+		return;
+	}
 	CharString c_level = p_level.utf8();
 	char *cstr_level = c_level.ptrw();
 	CharString c_message = p_message.utf8();
@@ -217,10 +888,105 @@ void OpenTelemetry::log_message(String p_level, String p_message, Dictionary p_a
 	String json_attributes = JSON::stringify(p_attributes, "", true, true);
 	CharString c_json_attributes = json_attributes.utf8();
 	char *cstr_json_attributes = c_json_attributes.ptrw();
-	LogMessage(cstr_level, cstr_message, cstr_json_attributes);
+	SpanContext context;
+	GetLogSpanContext(p_span_uuid, context);
+	LogMessage(severity_number, cstr_level, cstr_message, cstr_json_attributes, nullptr, context);
+}
+
+void OpenTelemetry::emit_log(int p_severity, String p_message, Dictionary p_attributes, String p_logger_name, String p_span_uuid) {
+	OverheadBudget::Scope overhead(overhead_budget);
+	if (!IsLogEnabled(p_severity, p_logger_name)) {
+		sdk_metrics.add_dropped(OtlpHttpExporter::SIGNAL_LOGS, SdkMetrics::DROP_SEVERITY);
+		return;
+	}
+	if (IsLogShed(p_severity)) {
+		sdk_metrics.add_dropped(OtlpHttpExporter::SIGNAL_LOGS, SdkMetrics::DROP_OVERHEAD_BUDGET);
+		return;
+	}
+	CharString c_message = p_message.utf8();
+	String json_attributes = p_attributes.is_empty() ? String() : JSON::stringify(p_attributes, "", true, true);
+	CharString c_json_attributes = json_attributes.utf8();
+	SpanContext context;
+	GetLogSpanContext(p_span_uuid, context);
+	LogMessage(p_severity, LogSeverity::get_text(p_severity), c_message.get_data(), c_json_attributes.get_data(), nullptr, context);
+}
+
+void OpenTelemetry::log_template(String p_level, String p_template, Array p_args, Dictionary p_attributes, String p_span_uuid) {
+	OverheadBudget::Scope overhead(overhead_budget);
+	int severity_number = LogSeverity::parse(p_level.ptr(), p_level.length());
+	if (!IsLogEnabled(severity_number, String())) {
+		sdk_metrics.add_dropped(OtlpHttpExporter::SIGNAL_LOGS, SdkMetrics::DROP_SEVERITY);
+		return;
+	}
+	if (IsLogShed(severity_number)) {
+		sdk_metrics.add_dropped(OtlpHttpExporter::SIGNAL_LOGS, SdkMetrics::DROP_OVERHEAD_BUDGET);
+		return;
+	}
+	// Arguments keep their types until the body is rendered at export.
+	// Objects are reduced to their text now, they may not outlive the call.
+	String template_args;
+	if (!p_args.is_empty()) {
+		Array args = p_args;
+		bool copied = false;
+		for (int i = 0; i < args.size(); i++) {
+			if (args[i].get_type() == Variant::OBJECT) {
+				if (!copied) {
+					// The caller's array is shared, not copied.
+					args = p_args.duplicate();
+					copied = true;
+				}
+				args[i] = String(args[i]);
+			}
+		}
+		template_args = UtilityFunctions::var_to_str(args);
+	}
+	CharString c_level = p_level.utf8();
+	CharString c_template = p_template.utf8();
+	String json_attributes = p_attributes.is_empty() ? String() : JSON::stringify(p_attributes, "", true, true);
+	CharString c_json_attributes = json_attributes.utf8();
+	CharString c_template_args = template_args.utf8();
+	SpanContext context;
+	GetLogSpanContext(p_span_uuid, context);
+	LogMessage(severity_number, c_level.get_data(), c_template.get_data(), c_json_attributes.get_data(), c_template_args.get_data(), context);
+}
+
+void OpenTelemetry::set_log_deduplication(double p_window_sec, double p_records_per_second, int p_burst) {
+	SetLogDeduplication(p_window_sec, p_records_per_second, p_burst);
+}
+
+bool OpenTelemetry::is_log_enabled(int p_severity, String p_logger_name) {
+	return IsLogEnabled(p_severity, p_logger_name) && !IsLogShed(p_severity);
+}
+
+void OpenTelemetry::set_min_log_severity(int p_severity, String p_logger_name) {
+	SetMinLogSeverity(p_severity, p_logger_name);
+}
+
+int OpenTelemetry::get_min_log_severity(String p_logger_name) {
+	return GetMinLogSeverity(p_logger_name);
+}
+
+void OpenTelemetry::capture_engine_logs(bool p_enabled, bool p_include_print) {
+	CaptureEngineLogs(p_enabled, p_include_print);
+}
+
+void OpenTelemetry::set_overhead_budget(double p_budget_ms, double p_sampling_ratio) {
+	SetOverheadBudget(p_budget_ms, p_sampling_ratio);
+}
+
+int OpenTelemetry::get_degradation_level() {
+	return overhead_budget.get_level();
+}
+
+Dictionary OpenTelemetry::get_stats() {
+	Dictionary stats = sdk_metrics.snapshot(metric_aggregator.get_total_series_count());
+	stats["degradation_level"] = overhead_budget.get_level();
+	stats["frame_overhead_usec"] = overhead_budget.get_average_nsec() / 1000;
+	return stats;
 }
 
 void OpenTelemetry::flush_all() {
+	OverheadBudget::Scope overhead(overhead_budget);
 	FlushAllBufferedData();
 }
 
@@ -232,15 +998,20 @@ String OpenTelemetry::shutdown() {
 // Internal implementation methods (moved from wrapper)
 char* OpenTelemetry::InitTracerProvider(const char* name, const char* host, const char* json_attributes) {
 	hostname = String(host);
+	otlp_exporter.configure(hostname);
 	tracer_name = String(name);
 	JSON json;
 	resource_attributes = json.parse_string(String(json_attributes));
 
-	// Initialize DuckDB database
+	// Initialize DuckDB database. The prepared log insert belongs to the
+	// previous connection, so it goes with it.
+	std::lock_guard<std::mutex> lock(db_mutex);
+	insert_log_statement.reset();
 	db = std::make_unique<duckdb::DuckDB>(nullptr);
 	conn = std::make_unique<duckdb::Connection>(*db);
 
-	// Create tables for spans, metrics, and logs
+	// Create tables for spans and logs. Metrics are aggregated in memory by
+	// metric_aggregator and only materialized at collection time.
 	auto& conn_ref = *conn;
 	conn_ref.Query("CREATE TABLE spans ("
 				   "name VARCHAR, "
@@ -252,34 +1023,22 @@ char* OpenTelemetry::InitTracerProvider(const char* name, const char* host, cons
 				   "status INTEGER, "
 				   "kind INTEGER, "
 				   "attributes VARCHAR, "
-				   "events VARCHAR)");
-
-	conn_ref.Query("CREATE TABLE metrics ("
-				   "name VARCHAR, "
-				   "value DOUBLE, "
-				   "unit VARCHAR, "
-				   "type INTEGER, "
-				   "timestamp BIGINT, "
-				   "attributes VARCHAR)");
+				   "events VARCHAR, "
+				   "trace_state VARCHAR)");
 
 	conn_ref.Query("CREATE TABLE logs ("
 				   "level VARCHAR, "
 				   "message VARCHAR, "
 				   "timestamp BIGINT, "
-				   "attributes VARCHAR)");
+				   "attributes VARCHAR, "
+				   "severity_number INTEGER, "
+				   "trace_id BLOB, "
+				   "span_id BLOB, "
+				   "trace_flags INTEGER, "
+				   "template_args VARCHAR)");
 
-	// Generate a random trace_id, 64-bit hex
-	Ref<Crypto> crypto;
-	crypto.instantiate();
-	PackedByteArray random_bytes = crypto->generate_random_bytes(8); // 64 bits for trace_id
-	String trace_id_hex = "";
-	for (int i = 0; i < 8; i++) {
-		uint64_t byte = random_bytes[i];
-		char byte_str[3];
-		snprintf(byte_str, sizeof(byte_str), "%02x", static_cast<uint8_t>(random_bytes[i]));
-		trace_id_hex += byte_str;
-	}
-	trace_id = trace_id_hex;
+	TailSampler::create_tables(conn_ref);
+	TailSampler::create_functions(conn_ref);
 
 	last_flush_time = Time::get_singleton()->get_ticks_msec();
 
@@ -293,14 +1052,106 @@ char* OpenTelemetry::SetHeaders(const char* json_headers) {
 	return strdup("OK");
 }
 
-char* OpenTelemetry::StartSpanWithId(const char* name, const char* span_id) {
+String OpenTelemetry::GenerateTraceId() {
+	// A random 128-bit W3C trace id, one per root span.
+	Ref<Crypto> crypto;
+	crypto.instantiate();
+	PackedByteArray random_bytes = crypto->generate_random_bytes(16);
+	char trace_id_hex[33];
+	for (int i = 0; i < 16; i++) {
+		snprintf(trace_id_hex + i * 2, 3, "%02x", static_cast<uint8_t>(random_bytes[i]));
+	}
+	return String(trace_id_hex);
+}
+
+bool OpenTelemetry::GetParentContext(const String& parent_span_uuid, SpanContext& parent) {
+	if (active_spans.has(parent_span_uuid)) {
+		Dictionary parent_span = active_spans[parent_span_uuid];
+		parent.trace_id = String(parent_span["trace_id"]).utf8().get_data();
+		parent.trace_state = String(parent_span["trace_state"]).utf8().get_data();
+		parent.span_id = TraceContextPropagator::to_w3c_span_id(parent_span_uuid.utf8().get_data());
+		return true;
+	}
+
+	// The parent may already have ended and be waiting in the buffer.
+	std::lock_guard<std::mutex> lock(db_mutex);
+	if (!conn) {
+		return false;
+	}
+	CharString c_parent_span_uuid = parent_span_uuid.utf8();
+	auto prepared = conn->Prepare("SELECT trace_id, trace_state FROM spans WHERE span_id = ? LIMIT 1");
+	auto result = prepared->Execute(std::string(c_parent_span_uuid.get_data()));
+	if (result->HasError()) {
+		return false;
+	}
+	auto chunk = result->Fetch();
+	if (!chunk || chunk->size() == 0) {
+		return false;
+	}
+	parent.trace_id = chunk->GetValue(0, 0).GetValue<std::string>();
+	parent.trace_state = chunk->GetValue(1, 0).GetValue<std::string>();
+	parent.span_id = TraceContextPropagator::to_w3c_span_id(c_parent_span_uuid.get_data());
+	return true;
+}
+
+SpanContext OpenTelemetry::GetSpanContext(const String& span_uuid) {
+	// Non-recording and unknown spans get an empty context.
+	SpanContext context;
+	if (span_uuid != non_recording_span_id && !GetParentContext(span_uuid, context)) {
+		context = SpanContext();
+	}
+	return context;
+}
+
+String OpenTelemetry::StartSpanWithRemoteParent(const String& name, const SpanContext& parent) {
+	String trace_id = String(parent.trace_id.c_str());
+	CharString c_name = name.utf8();
+	Sampler::Result sampling = ShouldSample(&parent, trace_id, c_name.get_data());
+	if (sampling.decision == Sampler::DECISION_DROP) {
+		return non_recording_span_id;
+	}
+	String span_id = generate_uuid_v7();
+	return start_span_with_parent_id(name, String(parent.span_id.c_str()), span_id, trace_id, sampling.trace_state);
+}
+
+Baggage OpenTelemetry::GetBaggage(const std::string& span_uuid) {
+	std::unordered_map<std::string, Baggage>::const_iterator it = span_baggage.find(span_uuid);
+	return it == span_baggage.end() ? Baggage() : it->second;
+}
+
+void OpenTelemetry::SetBaggage(const std::string& span_uuid, const Baggage& baggage) {
+	if (baggage.is_empty()) {
+		span_baggage.erase(span_uuid);
+	} else {
+		span_baggage[span_uuid] = baggage;
+	}
+}
+
+void OpenTelemetry::AddBaggageAttributes(Dictionary& attributes, const Baggage& baggage) {
+	std::vector<Baggage::Entry> entries;
+	baggage.get_all(entries);
+	for (const Baggage::Entry &entry : entries) {
+		if (!baggage_attribute_keys.empty() &&
+				std::find(baggage_attribute_keys.begin(), baggage_attribute_keys.end(), entry.name) == baggage_attribute_keys.end()) {
+			continue;
+		}
+		// Attributes set on the span itself take precedence.
+		String key = String::utf8(entry.name.c_str());
+		if (!attributes.has(key)) {
+			attributes[key] = String::utf8(entry.value.c_str());
+		}
+	}
+}
+
+char* OpenTelemetry::StartSpanWithId(const char* name, const char* span_id, const char* trace_id, const char* trace_state) {
 	uint64_t start_time = (uint64_t)(Time::get_singleton()->get_unix_time_from_system() * 1000000000ULL);
 
 	Dictionary span;
 	span["name"] = String(name);
 	span["span_id"] = String(span_id);
-	span["trace_id"] = trace_id;
+	span["trace_id"] = String(trace_id);
 	span["parent_span_id"] = String("");
+	span["trace_state"] = String::utf8(trace_state);
 	span["start_time_unix_nano"] = start_time;
 	span["status"] = 0; // UNSET
 	span["attributes"] = Dictionary();
@@ -308,18 +1159,20 @@ char* OpenTelemetry::StartSpanWithId(const char* name, const char* span_id) {
 	span["kind"] = 1; // INTERNAL
 
 	active_spans[String(span_id)] = span;
+	sdk_metrics.add_live_span(1);
 
 	return strdup(span_id);
 }
 
-char* OpenTelemetry::StartSpanWithParentWithId(const char* name, const char* parent_span_uuid, const char* span_id) {
+char* OpenTelemetry::StartSpanWithParentWithId(const char* name, const char* parent_span_uuid, const char* span_id, const char* trace_id, const char* trace_state) {
 	uint64_t start_time = (uint64_t)(Time::get_singleton()->get_unix_time_from_system() * 1000000000ULL);
 
 	Dictionary span;
 	span["name"] = String(name);
 	span["span_id"] = String(span_id);
-	span["trace_id"] = trace_id;
+	span["trace_id"] = String(trace_id);
 	span["parent_span_id"] = String(parent_span_uuid);
+	span["trace_state"] = String::utf8(trace_state);
 	span["start_time_unix_nano"] = start_time;
 	span["status"] = 0;
 	span["attributes"] = Dictionary();
@@ -327,10 +1180,123 @@ char* OpenTelemetry::StartSpanWithParentWithId(const char* name, const char* par
 	span["kind"] = 1;
 
 	active_spans[String(span_id)] = span;
+	sdk_metrics.add_live_span(1);
 
 	return strdup(span_id);
 }
 
+void OpenTelemetry::SetSampler(int sampler_type, double ratio) {
+	std::shared_ptr<Sampler> new_sampler;
+	switch (sampler_type) {
+		case SAMPLER_ALWAYS_ON:
+			new_sampler = std::make_shared<AlwaysOnSampler>();
+			break;
+		case SAMPLER_ALWAYS_OFF:
+			new_sampler = std::make_shared<AlwaysOffSampler>();
+			break;
+		case SAMPLER_TRACE_ID_RATIO:
+			new_sampler = std::make_shared<TraceIdRatioBasedSampler>(ratio);
+			break;
+		case SAMPLER_PARENT_BASED_ALWAYS_OFF:
+			new_sampler = std::make_shared<ParentBasedSampler>(std::make_shared<AlwaysOffSampler>());
+			break;
+		case SAMPLER_PARENT_BASED_TRACE_ID_RATIO:
+			new_sampler = std::make_shared<ParentBasedSampler>(std::make_shared<TraceIdRatioBasedSampler>(ratio));
+			break;
+		default:
+			new_sampler = std::make_shared<ParentBasedSampler>(std::make_shared<AlwaysOnSampler>());
+			break;
+	}
+	std::lock_guard<std::mutex> lock(sampler_mutex);
+	head_sampler = new_sampler;
+	PublishSampler();
+}
+
+void OpenTelemetry::SetSpanRateLimit(double spans_per_second, int burst) {
+	std::shared_ptr<SpanRateLimiter> previous;
+	{
+		std::lock_guard<std::mutex> lock(sampler_mutex);
+		previous = span_rate_limiter;
+		if (spans_per_second > 0.0) {
+			// By default a bucket holds one second worth of spans.
+			int capacity = burst > 0 ? burst : (int)std::ceil(spans_per_second);
+			std::atomic_store(&span_rate_limiter, std::make_shared<SpanRateLimiter>(spans_per_second, capacity));
+		} else {
+			std::atomic_store(&span_rate_limiter, std::shared_ptr<SpanRateLimiter>());
+		}
+		PublishSampler();
+	}
+	if (previous) {
+		// Keep the drops counted under the old limit.
+		ObserveDroppedSpans(previous, (uint64_t)(Time::get_singleton()->get_unix_time_from_system() * 1000000000ULL));
+	}
+}
+
+void OpenTelemetry::PublishSampler() {
+	std::shared_ptr<Sampler> new_sampler = head_sampler;
+	if (span_rate_limiter) {
+		new_sampler = std::make_shared<RateLimitingSampler>(head_sampler, span_rate_limiter);
+	}
+	std::atomic_store(&sampler, new_sampler);
+}
+
+void OpenTelemetry::ObserveDroppedSpans(const std::shared_ptr<SpanRateLimiter>& limiter, uint64_t collection_time) {
+	if (!limiter) {
+		return;
+	}
+	std::vector<std::pair<std::string, uint64_t>> dropped;
+	limiter->collect_dropped(dropped);
+	if (dropped.empty()) {
+		return;
+	}
+	std::shared_ptr<const MetricStream> stream = metric_views.resolve("otel.dropped", MetricAggregator::METRIC_TYPE_COUNTER);
+	if (stream->drop) {
+		return;
+	}
+	for (const std::pair<std::string, uint64_t> &entry : dropped) {
+		std::string attributes = MetricAggregator::OVERFLOW_ATTRIBUTES;
+		if (!entry.first.empty()) {
+			Dictionary span_name;
+			span_name["span.name"] = String::utf8(entry.first.c_str());
+			attributes = JSON::stringify(span_name, "", true, true).utf8().get_data();
+		}
+		metric_aggregator.record(*stream, "{span}", attributes, (double)entry.second, collection_time);
+	}
+}
+
+void OpenTelemetry::EnableTailSampling(const TailSampler::Policy& policy) {
+	std::lock_guard<std::mutex> lock(db_mutex);
+	tail_sampler.enable(policy);
+}
+
+void OpenTelemetry::DisableTailSampling() {
+	std::lock_guard<std::mutex> lock(db_mutex);
+	tail_sampler.disable();
+	if (conn) {
+		// Spans held for a decision are exported on the next flush.
+		conn->Query("DELETE FROM tail_sampling_decisions");
+	}
+}
+
+Sampler::Result OpenTelemetry::ShouldSample(const SpanContext* parent, const String& trace_id, const char* name) {
+	std::shared_ptr<Sampler> current = std::atomic_load(&sampler);
+	CharString c_trace_id = trace_id.utf8();
+	std::string trace_id_hex(c_trace_id.get_data());
+	if (!parent && overhead_budget.get_level() >= OverheadBudget::LEVEL_SAMPLED_TRACES) {
+		// Only new traces are shed, so traces already started stay whole.
+		std::shared_ptr<Sampler> budget_sampler = std::atomic_load(&overhead_sampler);
+		if (budget_sampler->should_sample(parent, trace_id_hex, name).decision == Sampler::DECISION_DROP) {
+			sdk_metrics.add_dropped(OtlpHttpExporter::SIGNAL_TRACES, SdkMetrics::DROP_OVERHEAD_BUDGET);
+			return Sampler::Result();
+		}
+	}
+	Sampler::Result result = current->should_sample(parent, trace_id_hex, name);
+	if (result.decision == Sampler::DECISION_DROP) {
+		sdk_metrics.add_dropped(OtlpHttpExporter::SIGNAL_TRACES, result.rate_limited ? SdkMetrics::DROP_RATE_LIMIT : SdkMetrics::DROP_SAMPLER);
+	}
+	return result;
+}
+
 void OpenTelemetry::AddEvent(const char* span_uuid, const char* event_name) {
 	String span_id_str = String(span_uuid);
 	if (active_spans.has(span_id_str)) {
@@ -390,34 +1356,137 @@ void OpenTelemetry::EndSpan(const char* span_uuid) {
 		uint64_t end_time = (uint64_t)(Time::get_singleton()->get_unix_time_from_system() * 1000000000ULL);
 		span["end_time_unix_nano"] = end_time;
 
-		// Insert span into DuckDB
-		std::lock_guard<std::mutex> lock(db_mutex);
-		JSON json;
-		String attributes_json = json.stringify(span["attributes"]);
-		String events_json = json.stringify(span["events"]);
-
-		std::string query = "INSERT INTO spans VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)";
-		auto prepared = conn->Prepare(query);
-		prepared->Execute(
-			std::string(span["name"].operator String().utf8().get_data()),
-			std::string(span["span_id"].operator String().utf8().get_data()),
-			std::string(span["trace_id"].operator String().utf8().get_data()),
-			std::string(span["parent_span_id"].operator String().utf8().get_data()),
-			span["start_time_unix_nano"].operator uint64_t(),
-			span["end_time_unix_nano"].operator uint64_t(),
-			span["status"].operator int(),
-			span["kind"].operator int(),
-			std::string(attributes_json.utf8().get_data()),
-			std::string(events_json.utf8().get_data())
-		);
+		std::unordered_map<std::string, Baggage>::iterator baggage = span_baggage.find(span_uuid);
+		if (baggage != span_baggage.end()) {
+			if (baggage_span_attributes) {
+				// Merged once at end, so the attributes are serialized once.
+				Dictionary attributes = span["attributes"];
+				AddBaggageAttributes(attributes, baggage->second);
+			}
+			span_baggage.erase(baggage);
+		}
+
+		InsertSpan(span);
 
 		active_spans.erase(span_id_str);
+		sdk_metrics.add_live_span(-1);
 
 		// Check if we should flush based on batch size
 		CheckAndFlush();
 	}
 }
 
+void OpenTelemetry::InsertSpan(const Dictionary& span) {
+	// Insert span into DuckDB
+	std::lock_guard<std::mutex> lock(db_mutex);
+	if (!conn) {
+		return;
+	}
+	JSON json;
+	String attributes_json = json.stringify(span["attributes"]);
+	String events_json = json.stringify(span["events"]);
+
+	std::string query = "INSERT INTO spans VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)";
+	auto prepared = conn->Prepare(query);
+	prepared->Execute(
+		std::string(span["name"].operator String().utf8().get_data()),
+		std::string(span["span_id"].operator String().utf8().get_data()),
+		std::string(span["trace_id"].operator String().utf8().get_data()),
+		std::string(span["parent_span_id"].operator String().utf8().get_data()),
+		span["start_time_unix_nano"].operator uint64_t(),
+		span["end_time_unix_nano"].operator uint64_t(),
+		span["status"].operator int(),
+		span["kind"].operator int(),
+		std::string(attributes_json.utf8().get_data()),
+		std::string(events_json.utf8().get_data()),
+		std::string(span["trace_state"].operator String().utf8().get_data())
+	);
+	sdk_metrics.add_pending(OtlpHttpExporter::SIGNAL_TRACES);
+}
+
+void OpenTelemetry::DisableFrameProfiler() {
+	if (frame_profiler.is_null()) {
+		return;
+	}
+	EngineDebugger *debugger = EngineDebugger::get_singleton();
+	if (debugger && debugger->has_profiler(OpenTelemetryProfiler::PROFILER_NAME)) {
+		debugger->profiler_enable(OpenTelemetryProfiler::PROFILER_NAME, false);
+		debugger->unregister_profiler(OpenTelemetryProfiler::PROFILER_NAME);
+	}
+	frame_profiler->set_callback(OpenTelemetryProfiler::FrameCallback());
+	frame_profiler.unref();
+}
+
+static Dictionary make_completed_span(const String &p_name, const String &p_span_id, const String &p_trace_id, const String &p_parent_span_id, uint64_t p_start, uint64_t p_end, const std::string &p_trace_state) {
+	Dictionary span;
+	span["name"] = p_name;
+	span["span_id"] = p_span_id;
+	span["trace_id"] = p_trace_id;
+	span["parent_span_id"] = p_parent_span_id;
+	span["trace_state"] = String::utf8(p_trace_state.c_str());
+	span["start_time_unix_nano"] = p_start;
+	span["end_time_unix_nano"] = p_end;
+	span["status"] = 0;
+	span["attributes"] = Dictionary();
+	span["events"] = Array();
+	span["kind"] = 1;
+	return span;
+}
+
+void OpenTelemetry::RecordFrameHistogram(const char* name, double value, const std::string& attributes, uint64_t time) {
+	std::shared_ptr<const MetricStream> stream = metric_views.resolve(name, MetricAggregator::METRIC_TYPE_HISTOGRAM);
+	if (!stream->drop) {
+		metric_aggregator.record(*stream, "s", attributes, value, time);
+	}
+}
+
+void OpenTelemetry::RecordProfilerFrame(const OpenTelemetryProfiler::Frame& frame) {
+	OverheadBudget::Scope overhead(overhead_budget);
+	if (!conn) {
+		return;
+	}
+	uint64_t now = (uint64_t)(Time::get_singleton()->get_unix_time_from_system() * 1000000000ULL);
+	uint64_t frame_start = now - (uint64_t)(frame.frame_time * 1000000000.0);
+
+	if (frame_profiler_metrics) {
+		static const std::string no_attributes = "{}";
+		RecordFrameHistogram("godot.frame.time", frame.frame_time, no_attributes, now);
+		RecordFrameHistogram("godot.frame.process_time", frame.process_time, no_attributes, now);
+		RecordFrameHistogram("godot.frame.physics_time", frame.physics_time, no_attributes, now);
+		for (const std::pair<std::string, double> &section : frame.sections) {
+			Dictionary attributes;
+			attributes["godot.frame.section"] = String::utf8(section.first.c_str());
+			RecordFrameHistogram("godot.frame.section_time", section.second, JSON::stringify(attributes, "", true, true).utf8().get_data(), now);
+		}
+	}
+
+	if (frame_profiler_spans && overhead_budget.get_level() < OverheadBudget::LEVEL_AGGREGATED_METRICS) {
+		// Each sampled frame is its own trace. The engine runs the physics
+		// steps before process, which fixes the order of the child spans.
+		String trace_id = GenerateTraceId();
+		Sampler::Result sampling = ShouldSample(nullptr, trace_id, "godot.frame");
+		if (sampling.decision != Sampler::DECISION_DROP) {
+			String frame_span_id = generate_uuid_v7();
+			Dictionary frame_span = make_completed_span("godot.frame", frame_span_id, trace_id, String(), frame_start, now, sampling.trace_state);
+			Dictionary attributes = frame_span["attributes"];
+			attributes["godot.frame.number"] = (int64_t)frame.frame;
+			attributes["godot.physics.frame_time"] = frame.physics_frame_time;
+			InsertSpan(frame_span);
+
+			uint64_t physics_end = frame_start + (uint64_t)(frame.physics_time * 1000000000.0);
+			uint64_t process_end = physics_end + (uint64_t)(frame.process_time * 1000000000.0);
+			InsertSpan(make_completed_span("godot.physics", generate_uuid_v7(), trace_id, frame_span_id, frame_start, physics_end, sampling.trace_state));
+			InsertSpan(make_completed_span("godot.process", generate_uuid_v7(), trace_id, frame_span_id, physics_end, process_end, sampling.trace_state));
+			for (const std::pair<std::string, double> &section : frame.sections) {
+				uint64_t section_end = frame_start + (uint64_t)(section.second * 1000000000.0);
+				InsertSpan(make_completed_span(String::utf8(section.first.c_str()), generate_uuid_v7(), trace_id, frame_span_id, frame_start, section_end, sampling.trace_state));
+			}
+		}
+	}
+
+	CheckAndFlush();
+}
+
 void OpenTelemetry::SetFlushInterval(int interval_ms) {
 	flush_interval_ms = interval_ms;
 }
@@ -426,52 +1495,488 @@ void OpenTelemetry::SetBatchSize(int size) {
 	batch_size = size;
 }
 
-void OpenTelemetry::RecordMetric(const char* name, double value, const char* unit, int metric_type, const char* json_attributes) {
+void OpenTelemetry::RecordMetric(const MetricStream& stream, double value, const char* unit, const char* json_attributes) {
 	uint64_t timestamp = (uint64_t)(Time::get_singleton()->get_unix_time_from_system() * 1000000000ULL);
 
-	// Insert metric into DuckDB
-	std::lock_guard<std::mutex> lock(db_mutex);
+	// Aggregate into the in-memory series for this attribute set. The
+	// attribute JSON is produced with sorted keys, so it doubles as the key.
 	std::string attributes_json = "{}";
 	if (json_attributes && strlen(json_attributes) > 0) {
 		attributes_json = json_attributes;
 	}
+	// Exemplars are the first thing dropped when over the overhead budget.
+	const SpanContext *span_context = nullptr;
+	if (overhead_budget.get_level() < OverheadBudget::LEVEL_AGGREGATED_METRICS) {
+		span_context = ActiveSpanStack::get_current_context();
+	}
+	metric_aggregator.record(stream, std::string(unit), attributes_json, value, timestamp, span_context);
 
-	std::string query = "INSERT INTO metrics VALUES (?, ?, ?, ?, ?, ?)";
-	auto prepared = conn->Prepare(query);
-	prepared->Execute(
-		std::string(name),
-		value,
-		std::string(unit),
-		metric_type,
-		timestamp,
-		attributes_json
-	);
-
-	// Check if we should flush based on batch size
+	// Check if we should flush based on the flush interval
 	CheckAndFlush();
 }
 
-void OpenTelemetry::LogMessage(const char* level, const char* message, const char* json_attributes) {
-	uint64_t timestamp = (uint64_t)(Time::get_singleton()->get_unix_time_from_system() * 1000000000ULL);
+void OpenTelemetry::SetMetricTemporality(int temporality) {
+	metric_aggregator.set_temporality(temporality);
+}
 
-	// Insert log into DuckDB
-	std::lock_guard<std::mutex> lock(db_mutex);
-	std::string attributes_json = "{}";
+void OpenTelemetry::SetCardinalityLimit(int limit) {
+	metric_aggregator.set_default_cardinality_limit(limit);
+}
+
+void OpenTelemetry::SetInstrumentCardinalityLimit(const char* name, int limit) {
+	metric_aggregator.set_cardinality_limit(std::string(name), limit);
+}
+
+void OpenTelemetry::SetExemplarFilter(int filter) {
+	metric_aggregator.set_exemplar_filter(filter);
+}
+
+void OpenTelemetry::SetExemplarReservoirSize(int size) {
+	metric_aggregator.set_exemplar_reservoir_size(size);
+}
+
+void OpenTelemetry::SetSketchRelativeAccuracy(double relative_accuracy) {
+	metric_aggregator.set_sketch_relative_accuracy(relative_accuracy);
+}
+
+void OpenTelemetry::SetSketchMaxBuckets(int max_buckets) {
+	metric_aggregator.set_sketch_max_buckets(max_buckets);
+}
+
+void OpenTelemetry::SetSketchQuantiles(const std::vector<double>& quantiles) {
+	metric_aggregator.set_sketch_quantiles(quantiles);
+}
+
+void OpenTelemetry::AddMetricView(const MetricView& view) {
+	metric_views.add_view(view);
+}
+
+void OpenTelemetry::ClearMetricViews() {
+	metric_views.clear();
+}
+
+void OpenTelemetry::SetEngineMetrics(int groups) {
+	engine_metric_groups = (uint32_t)groups;
+	UpdateProcessFrameConnection();
+}
+
+int OpenTelemetry::StartPrometheusExporter(int port, const String& bind_address) {
+	bool was_listening = prometheus_exporter.is_listening();
+	Error err = prometheus_exporter.start(port, bind_address);
+	if (err == OK) {
+		// Prometheus expects counters and histograms to accumulate.
+		if (!was_listening) {
+			prometheus_previous_temporality = metric_aggregator.get_temporality();
+		}
+		metric_aggregator.set_temporality(MetricAggregator::TEMPORALITY_CUMULATIVE);
+	} else if (was_listening) {
+		// start() stopped the previous listener before failing.
+		metric_aggregator.set_temporality(prometheus_previous_temporality);
+	}
+	UpdateProcessFrameConnection();
+	return err;
+}
+
+void OpenTelemetry::StopPrometheusExporter() {
+	if (prometheus_exporter.is_listening()) {
+		metric_aggregator.set_temporality(prometheus_previous_temporality);
+	}
+	prometheus_exporter.stop();
+	UpdateProcessFrameConnection();
+}
+
+std::string OpenTelemetry::RenderOpenMetrics() {
+	// A scrape is a collection for the pull exporter, so observable
+	// instruments are sampled here rather than at flush time.
+	uint64_t collection_time = (uint64_t)(Time::get_singleton()->get_unix_time_from_system() * 1000000000ULL);
+	EngineMetrics::observe(engine_metric_groups, metric_views, metric_aggregator, collection_time);
+	ObserveDroppedSpans(std::atomic_load(&span_rate_limiter), collection_time);
+	sdk_metrics.observe(metric_views, metric_aggregator, collection_time);
+	overhead_budget.observe(metric_views, metric_aggregator, collection_time);
+
+	std::vector<std::string> names;
+	metric_aggregator.get_instrument_names(names);
+	std::sort(names.begin(), names.end());
+
+	// Each instrument is snapshotted under its own short lock, so recording
+	// continues while the page is rendered.
+	OpenMetricsWriter writer;
+	std::vector<MetricPoint> points;
+	for (const std::string &name : names) {
+		points.clear();
+		metric_aggregator.snapshot(name, collection_time, points);
+		writer.write_family(name, points);
+	}
+	writer.write_eof();
+	return writer.get_text();
+}
+
+void OpenTelemetry::UpdateProcessFrameConnection() {
+	// Observable instruments and the pull exporter need to run even when
+	// nothing else is being recorded.
+	SceneTree *tree = Object::cast_to<SceneTree>(Engine::get_singleton()->get_main_loop());
+	if (!tree) {
+		return;
+	}
+	bool wanted = engine_metric_groups != 0 || prometheus_exporter.is_listening() || engine_logger.is_valid() || overhead_budget.is_enabled();
+	Callable callback = callable_mp(this, &OpenTelemetry::_on_process_frame);
+	bool connected = tree->is_connected("process_frame", callback);
+	if (wanted && !connected) {
+		tree->connect("process_frame", callback);
+	} else if (!wanted && connected) {
+		tree->disconnect("process_frame", callback);
+	}
+}
+
+void OpenTelemetry::_on_process_frame() {
+	if (overhead_budget.end_frame()) {
+		ApplyDegradationLevel();
+	}
+	OverheadBudget::Scope overhead(overhead_budget);
+	if (prometheus_exporter.is_listening()) {
+		prometheus_exporter.poll([this]() { return RenderOpenMetrics(); });
+	}
+	if (!conn) {
+		return;
+	}
+	DrainEngineLogs();
+	CollectLogSummaries(false);
+	uint64_t current_time = Time::get_singleton()->get_ticks_msec();
+	if ((current_time - last_flush_time) >= (uint64_t)flush_interval_ms) {
+		FlushAllBufferedData();
+	}
+}
+
+Dictionary OpenTelemetry::MetricPointToOtlpMetric(const MetricPoint& point, const Array& data_points) {
+	Dictionary metric;
+	metric["name"] = String::utf8(point.name.c_str());
+	metric["unit"] = String::utf8(point.unit.c_str());
+
+	Dictionary data;
+	data["dataPoints"] = data_points;
+	switch (point.type) {
+		case MetricAggregator::METRIC_TYPE_GAUGE:
+			metric["gauge"] = data;
+			break;
+		case MetricAggregator::METRIC_TYPE_COUNTER:
+		case MetricAggregator::METRIC_TYPE_UP_DOWN_COUNTER:
+			data["aggregationTemporality"] = point.temporality;
+			data["isMonotonic"] = point.type == MetricAggregator::METRIC_TYPE_COUNTER;
+			metric["sum"] = data;
+			break;
+		case MetricAggregator::METRIC_TYPE_HISTOGRAM:
+			data["aggregationTemporality"] = point.temporality;
+			metric["histogram"] = data;
+			break;
+		case MetricAggregator::METRIC_TYPE_SKETCH:
+			// Sketch buckets use the base-2 exponential mapping, so they are
+			// exported as they are; backends derive quantiles from them.
+			data["aggregationTemporality"] = point.temporality;
+			metric["exponentialHistogram"] = data;
+			break;
+	}
+	return metric;
+}
+
+Dictionary OpenTelemetry::MetricPointToOtlpDataPoint(const MetricPoint& point) {
+	Dictionary data_point;
+	JSON json;
+	data_point["attributes"] = make_otlp_attributes(json.parse_string(String::utf8(point.attributes.c_str())));
+	data_point["startTimeUnixNano"] = otlp_uint64(point.start_time_unix_nano);
+	data_point["timeUnixNano"] = otlp_uint64(point.time_unix_nano);
+
+	if (point.type == MetricAggregator::METRIC_TYPE_HISTOGRAM) {
+		data_point["count"] = otlp_uint64(point.count);
+		data_point["sum"] = point.sum;
+		data_point["min"] = point.min;
+		data_point["max"] = point.max;
+
+		Array explicit_bounds;
+		for (double bound : point.bucket_bounds) {
+			explicit_bounds.push_back(bound);
+		}
+		data_point["explicitBounds"] = explicit_bounds;
+
+		Array bucket_counts;
+		for (uint64_t bucket_count : point.bucket_counts) {
+			bucket_counts.push_back(otlp_uint64(bucket_count));
+		}
+		data_point["bucketCounts"] = bucket_counts;
+	} else if (point.type == MetricAggregator::METRIC_TYPE_SKETCH) {
+		data_point["count"] = otlp_uint64(point.count);
+		data_point["sum"] = point.sum;
+		data_point["min"] = point.min;
+		data_point["max"] = point.max;
+		data_point["scale"] = point.scale;
+		data_point["zeroCount"] = otlp_uint64(point.zero_count);
+
+		Dictionary positive;
+		positive["offset"] = point.positive_offset;
+		Array positive_counts;
+		for (uint64_t bucket_count : point.positive_bucket_counts) {
+			positive_counts.push_back(otlp_uint64(bucket_count));
+		}
+		positive["bucketCounts"] = positive_counts;
+		data_point["positive"] = positive;
+
+		Dictionary negative;
+		negative["offset"] = point.negative_offset;
+		Array negative_counts;
+		for (uint64_t bucket_count : point.negative_bucket_counts) {
+			negative_counts.push_back(otlp_uint64(bucket_count));
+		}
+		negative["bucketCounts"] = negative_counts;
+		data_point["negative"] = negative;
+	} else {
+		data_point["asDouble"] = point.value;
+	}
+
+	if (!point.exemplars.empty()) {
+		Array exemplars;
+		for (const MetricExemplar &exemplar : point.exemplars) {
+			Dictionary exemplar_dict;
+			exemplar_dict["asDouble"] = exemplar.value;
+			exemplar_dict["timeUnixNano"] = otlp_uint64(exemplar.time_unix_nano);
+			if (!exemplar.trace_id.empty()) {
+				exemplar_dict["traceId"] = String(exemplar.trace_id.c_str());
+				exemplar_dict["spanId"] = String(TraceContextPropagator::to_w3c_span_id(exemplar.span_id).c_str());
+			}
+			exemplars.push_back(exemplar_dict);
+		}
+		data_point["exemplars"] = exemplars;
+	}
+	return data_point;
+}
+
+bool OpenTelemetry::IsLogEnabled(int severity_number, const String& logger_name) {
+	if (has_logger_min_log_severities.load(std::memory_order_acquire) && !logger_name.is_empty()) {
+		return severity_number >= GetMinLogSeverity(logger_name);
+	}
+	return severity_number >= min_log_severity.load(std::memory_order_relaxed);
+}
+
+int OpenTelemetry::GetMinLogSeverity(const String& logger_name) {
+	if (!logger_name.is_empty() && has_logger_min_log_severities.load(std::memory_order_acquire)) {
+		std::shared_ptr<const HashMap<String, int>> overrides = std::atomic_load(&logger_min_log_severities);
+		if (overrides) {
+			HashMap<String, int>::ConstIterator it = overrides->find(logger_name);
+			if (it != overrides->end()) {
+				return it->value;
+			}
+		}
+	}
+	return min_log_severity.load(std::memory_order_relaxed);
+}
+
+void OpenTelemetry::SetMinLogSeverity(int severity_number, const String& logger_name) {
+	severity_number = std::min(std::max(severity_number, (int)LogSeverity::SEVERITY_UNSPECIFIED), (int)LogSeverity::SEVERITY_MAX);
+	{
+		std::lock_guard<std::mutex> lock(log_severity_mutex);
+		if (logger_name.is_empty()) {
+			min_log_severity.store(severity_number, std::memory_order_relaxed);
+		} else {
+			// Readers keep the map they loaded, so changes go to a copy.
+			std::shared_ptr<HashMap<String, int>> overrides = std::make_shared<HashMap<String, int>>();
+			std::shared_ptr<const HashMap<String, int>> current = std::atomic_load(&logger_min_log_severities);
+			if (current) {
+				*overrides = *current;
+			}
+			// Unspecified removes the override, the logger then uses the default.
+			if (severity_number == LogSeverity::SEVERITY_UNSPECIFIED) {
+				overrides->erase(logger_name);
+			} else {
+				overrides->insert(logger_name, severity_number);
+			}
+			bool has_overrides = !overrides->is_empty();
+			std::atomic_store(&logger_min_log_severities, std::shared_ptr<const HashMap<String, int>>(has_overrides ? overrides : nullptr));
+			has_logger_min_log_severities.store(has_overrides, std::memory_order_release);
+		}
+	}
+	if (engine_logger.is_valid()) {
+		engine_logger->set_min_severity(GetEngineLogMinSeverity());
+	}
+}
+
+bool OpenTelemetry::IsLogShed(int severity_number) {
+	// Records without a known severity are kept, they may be anything.
+	return severity_number != LogSeverity::SEVERITY_UNSPECIFIED && severity_number < LogSeverity::SEVERITY_INFO &&
+			overhead_budget.get_level() >= OverheadBudget::LEVEL_NO_DEBUG_LOGS;
+}
+
+int OpenTelemetry::GetEngineLogMinSeverity() {
+	int severity_number = GetMinLogSeverity(OpenTelemetryLogger::LOGGER_NAME);
+	if (overhead_budget.get_level() >= OverheadBudget::LEVEL_NO_DEBUG_LOGS) {
+		severity_number = std::max(severity_number, (int)LogSeverity::SEVERITY_INFO);
+	}
+	return severity_number;
+}
+
+bool OpenTelemetry::GetLogSpanContext(const String& span_uuid, SpanContext& context) {
+	// An explicit span wins over the active span.
+	if (span_uuid.is_empty()) {
+		return get_active_span_context(context);
+	}
+	return span_uuid != non_recording_span_id && GetParentContext(span_uuid, context);
+}
+
+void OpenTelemetry::LogMessage(int severity_number, const char* level, const char* message, const char* json_attributes, const char* template_args, const SpanContext& context) {
+	LogRecordData record;
+	record.severity_number = severity_number;
+	record.level = level;
+	record.message = message;
 	if (json_attributes && strlen(json_attributes) > 0) {
-		attributes_json = json_attributes;
+		record.attributes = json_attributes;
+	}
+	if (template_args) {
+		record.template_args = template_args;
 	}
+	record.time_unix_nano = (uint64_t)(Time::get_singleton()->get_unix_time_from_system() * 1000000000ULL);
+	record.span_context = context;
 
-	std::string query = "INSERT INTO logs VALUES (?, ?, ?, ?)";
-	auto prepared = conn->Prepare(query);
-	prepared->Execute(
-		std::string(level),
-		std::string(message),
-		timestamp,
-		attributes_json
-	);
+	// Insert log into DuckDB
+	bool written;
+	{
+		std::lock_guard<std::mutex> lock(db_mutex);
+		written = WriteLogRecord(record);
+	}
 
 	// Check if we should flush based on batch size
-	CheckAndFlush();
+	if (written) {
+		CheckAndFlush();
+	}
+}
+
+bool OpenTelemetry::WriteLogRecord(const LogRecordData& record) {
+	if (!log_deduplicator.offer(record)) {
+		sdk_metrics.add_dropped(OtlpHttpExporter::SIGNAL_LOGS, SdkMetrics::DROP_DEDUPLICATED);
+		return false;
+	}
+	InsertLogRecord(record);
+	return true;
+}
+
+void OpenTelemetry::InsertLogRecord(const LogRecordData& record) {
+	if (!insert_log_statement) {
+		insert_log_statement = conn->Prepare("INSERT INTO logs VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)");
+	}
+	LogContextColumns context_columns = make_log_context_columns(record.span_context);
+	insert_log_statement->Execute(
+		record.level,
+		record.message,
+		record.time_unix_nano,
+		record.attributes,
+		record.severity_number,
+		context_columns.trace_id,
+		context_columns.span_id,
+		context_columns.flags,
+		record.template_args.empty() ? duckdb::Value(duckdb::LogicalType::VARCHAR) : duckdb::Value(record.template_args)
+	);
+	sdk_metrics.add_pending(OtlpHttpExporter::SIGNAL_LOGS);
+}
+
+void OpenTelemetry::SetLogDeduplication(double window_sec, double records_per_second, int burst) {
+	CollectLogSummaries(true);
+	std::lock_guard<std::mutex> lock(db_mutex);
+	log_deduplicator.configure(window_sec, records_per_second, burst);
+}
+
+void OpenTelemetry::CollectLogSummaries(bool all) {
+	std::lock_guard<std::mutex> lock(db_mutex);
+	if (!conn || !log_deduplicator.is_enabled()) {
+		return;
+	}
+	std::vector<LogRecordData> summaries;
+	log_deduplicator.collect((uint64_t)(Time::get_singleton()->get_unix_time_from_system() * 1000000000ULL), all, summaries);
+	for (const LogRecordData& summary : summaries) {
+		InsertLogRecord(summary);
+	}
+}
+
+void OpenTelemetry::CaptureEngineLogs(bool enabled, bool include_print) {
+	OS *os = OS::get_singleton();
+	if (enabled) {
+		if (engine_logger.is_null()) {
+			engine_log_queue = std::make_shared<EngineLogQueue>();
+			engine_logger.instantiate();
+			engine_logger->setup(engine_log_queue, &get_active_span_context, include_print);
+			engine_logger->set_min_severity(GetEngineLogMinSeverity());
+			os->add_logger(engine_logger);
+		} else {
+			engine_logger->set_capture_messages(include_print);
+		}
+	} else if (engine_logger.is_valid()) {
+		if (os) {
+			os->remove_logger(engine_logger);
+		}
+		engine_logger.unref();
+	}
+	UpdateProcessFrameConnection();
+}
+
+void OpenTelemetry::DrainEngineLogs() {
+	if (!engine_log_queue) {
+		return;
+	}
+	std::lock_guard<std::mutex> lock(db_mutex);
+	if (!conn) {
+		return;
+	}
+
+	EngineLogRecord record;
+	while (engine_log_queue->try_pop(record)) {
+		// Attribute names follow the code and exception semantic conventions.
+		Dictionary attributes;
+		if (!record.file.empty()) {
+			attributes["code.function.name"] = String::utf8(record.function.c_str());
+			attributes["code.file.path"] = String::utf8(record.file.c_str());
+			attributes["code.line.number"] = record.line;
+		}
+		if (!record.backtrace.empty()) {
+			attributes["code.stacktrace"] = String::utf8(record.backtrace.c_str());
+		}
+		if (record.error_type >= 0) {
+			static const char *error_types[] = { "error", "warning", "script", "shader" };
+			if (record.error_type < 4) {
+				attributes["godot.error.type"] = error_types[record.error_type];
+			}
+		}
+
+		LogRecordData log_record;
+		log_record.severity_number = record.severity_number;
+		log_record.level = LogSeverity::get_text(record.severity_number);
+		log_record.message = std::move(record.message);
+		log_record.attributes = JSON::stringify(attributes, "", true, true).utf8().get_data();
+		log_record.time_unix_nano = record.time_unix_nano;
+		log_record.span_context = std::move(record.span_context);
+		WriteLogRecord(log_record);
+	}
+
+	uint64_t dropped = engine_log_queue->take_dropped();
+	if (dropped > 0) {
+		sdk_metrics.add_dropped(OtlpHttpExporter::SIGNAL_LOGS, SdkMetrics::DROP_QUEUE_FULL, dropped);
+		// Not deduplicated: the count makes each of these unique anyway.
+		LogRecordData log_record;
+		log_record.severity_number = LogSeverity::SEVERITY_WARN;
+		log_record.level = LogSeverity::get_text(LogSeverity::SEVERITY_WARN);
+		log_record.message = std::to_string(dropped) + " engine log records dropped, the capture queue was full";
+		log_record.time_unix_nano = (uint64_t)(Time::get_singleton()->get_unix_time_from_system() * 1000000000ULL);
+		InsertLogRecord(log_record);
+	}
+}
+
+void OpenTelemetry::SetOverheadBudget(double budget_ms, double sampling_ratio) {
+	std::atomic_store(&overhead_sampler, std::shared_ptr<Sampler>(std::make_shared<TraceIdRatioBasedSampler>(std::min(std::max(sampling_ratio, 0.0), 1.0))));
+	overhead_budget.configure(budget_ms * 1000.0);
+	ApplyDegradationLevel();
+	UpdateProcessFrameConnection();
+}
+
+void OpenTelemetry::ApplyDegradationLevel() {
+	// The other levels are checked where they apply; captured engine logs
+	// are filtered before they are queued, so the logger is told.
+	if (engine_logger.is_valid()) {
+		engine_logger->set_min_severity(GetEngineLogMinSeverity());
+	}
 }
 
 void OpenTelemetry::CheckAndFlush() {
@@ -482,15 +1987,16 @@ void OpenTelemetry::CheckAndFlush() {
 	{
 		std::lock_guard<std::mutex> lock(db_mutex);
 		auto spans_result = conn->Query("SELECT COUNT(*) FROM spans");
-		auto metrics_result = conn->Query("SELECT COUNT(*) FROM metrics");
 		auto logs_result = conn->Query("SELECT COUNT(*) FROM logs");
 
 		int64_t spans_count = spans_result->GetValue(0, 0).GetValue<int64_t>();
-		int64_t metrics_count = metrics_result->GetValue(0, 0).GetValue<int64_t>();
 		int64_t logs_count = logs_result->GetValue(0, 0).GetValue<int64_t>();
 
-		should_flush_batch = spans_count >= batch_size ||
-						   metrics_count >= batch_size ||
+		// Metrics are aggregated in memory, so their footprint does not grow
+		// with the number of measurements and only the interval applies.
+		// Spans held for tail sampling are bounded by its max hold time
+		// instead, since a flush could not export them early anyway.
+		should_flush_batch = (!tail_sampler.is_enabled() && spans_count >= batch_size) ||
 						   logs_count >= batch_size;
 	}
 
@@ -500,13 +2006,10 @@ void OpenTelemetry::CheckAndFlush() {
 }
 
 void OpenTelemetry::FlushAllBufferedData() {
+	DrainEngineLogs();
+	CollectLogSummaries(false);
 	std::lock_guard<std::mutex> lock(db_mutex);
 
-	Ref<HTTPClient> http;
-	http.instantiate();
-	Ref<TLSOptions> tls;
-	tls.instantiate();
-	http->connect_to_host("otel.logflare.app", 443, tls);
 	PackedStringArray headers_array;
 	headers_array.push_back("Content-Type: application/json");
 
@@ -517,14 +2020,25 @@ void OpenTelemetry::FlushAllBufferedData() {
 
 	uint64_t current_time = Time::get_singleton()->get_ticks_msec();
 
+	Dictionary resource;
+	resource["attributes"] = make_otlp_attributes(resource_attributes);
+
 	// Flush traces
 	{
-		auto spans_result = conn->Query("SELECT * FROM spans");
+		// With tail sampling only spans of traces decided as kept are
+		// exported; undecided traces stay buffered.
+		std::string spans_filter;
+		if (tail_sampler.is_enabled()) {
+			tail_sampler.decide(*conn, (uint64_t)(Time::get_singleton()->get_unix_time_from_system() * 1000000000ULL));
+			spans_filter = TailSampler::KEPT_SPANS_FILTER;
+		}
+
+		auto spans_result = conn->Query("SELECT * FROM spans" + spans_filter);
 		if (spans_result->RowCount() > 0) {
 			Dictionary root;
 			Array resourceSpans;
 			Dictionary resourceSpan;
-			resourceSpan["resource"] = resource_attributes;
+			resourceSpan["resource"] = resource;
 
 			Array scopeSpans;
 			Dictionary scopeSpan;
@@ -536,22 +2050,44 @@ void OpenTelemetry::FlushAllBufferedData() {
 			Array spansArray;
 			for (size_t i = 0; i < spans_result->RowCount(); i++) {
 				Dictionary span;
-				span["name"] = String(spans_result->GetValue(0, i).GetValue<std::string>().c_str());
-				span["span_id"] = String(spans_result->GetValue(1, i).GetValue<std::string>().c_str());
-				span["trace_id"] = String(spans_result->GetValue(2, i).GetValue<std::string>().c_str());
-				span["parent_span_id"] = String(spans_result->GetValue(3, i).GetValue<std::string>().c_str());
-				span["start_time_unix_nano"] = spans_result->GetValue(4, i).GetValue<uint64_t>();
-				span["end_time_unix_nano"] = spans_result->GetValue(5, i).GetValue<uint64_t>();
-				span["status"] = spans_result->GetValue(6, i).GetValue<int32_t>();
+				span["name"] = String::utf8(spans_result->GetValue(0, i).GetValue<std::string>().c_str());
+				// The buffer keys spans by their UUID handle; exported ids use
+				// the same 16 hex digit W3C form as propagated contexts and logs.
+				span["spanId"] = String(TraceContextPropagator::to_w3c_span_id(spans_result->GetValue(1, i).GetValue<std::string>()).c_str());
+				span["traceId"] = String(spans_result->GetValue(2, i).GetValue<std::string>().c_str());
+				String parent_span_id = String(TraceContextPropagator::to_w3c_span_id(spans_result->GetValue(3, i).GetValue<std::string>()).c_str());
+				if (!parent_span_id.is_empty()) {
+					span["parentSpanId"] = parent_span_id;
+				}
+				span["startTimeUnixNano"] = otlp_uint64(spans_result->GetValue(4, i).GetValue<uint64_t>());
+				span["endTimeUnixNano"] = otlp_uint64(spans_result->GetValue(5, i).GetValue<uint64_t>());
+				Dictionary status;
+				status["code"] = spans_result->GetValue(6, i).GetValue<int32_t>();
+				span["status"] = status;
 				span["kind"] = spans_result->GetValue(7, i).GetValue<int32_t>();
 
 				// Parse JSON strings back to Dictionaries
 				JSON json;
-				String attributes_json = String(spans_result->GetValue(8, i).GetValue<std::string>().c_str());
-				span["attributes"] = json.parse_string(attributes_json);
-
-				String events_json = String(spans_result->GetValue(9, i).GetValue<std::string>().c_str());
-				span["events"] = json.parse_string(events_json);
+				String attributes_json = String::utf8(spans_result->GetValue(8, i).GetValue<std::string>().c_str());
+				span["attributes"] = make_otlp_attributes(json.parse_string(attributes_json));
+
+				String events_json = String::utf8(spans_result->GetValue(9, i).GetValue<std::string>().c_str());
+				Array events = json.parse_string(events_json);
+				Array otlp_events;
+				for (const Variant &event_variant : events) {
+					Dictionary event = event_variant;
+					Dictionary otlp_event;
+					otlp_event["name"] = event.get("name", String());
+					otlp_event["timeUnixNano"] = otlp_uint64((uint64_t)(double)event.get("time_unix_nano", 0));
+					otlp_event["attributes"] = make_otlp_attributes(event.get("attributes", Dictionary()));
+					otlp_events.push_back(otlp_event);
+				}
+				span["events"] = otlp_events;
+
+				String trace_state = String::utf8(spans_result->GetValue(10, i).GetValue<std::string>().c_str());
+				if (!trace_state.is_empty()) {
+					span["traceState"] = trace_state;
+				}
 
 				spansArray.push_back(span);
 			}
@@ -565,21 +2101,29 @@ void OpenTelemetry::FlushAllBufferedData() {
 
 			JSON json;
 			String jsonPayload = json.stringify(root);
-			http->request(HTTPClient::Method::METHOD_POST, "/v1/traces", headers_array, jsonPayload);
 
-			// Clear spans table
-			conn->Query("DELETE FROM spans");
+			// The export thread owns the batch from here, retries included.
+			ExportBatch(OtlpHttpExporter::SIGNAL_TRACES, headers_array, jsonPayload, spans_result->RowCount(), true);
+			conn->Query("DELETE FROM spans" + spans_filter);
 		}
 	}
 
-	// Flush metrics
-	{
-		auto metrics_result = conn->Query("SELECT * FROM metrics");
-		if (metrics_result->RowCount() > 0) {
+	// Flush metrics. With the pull exporter active, metrics are served on
+	// scrape instead of being pushed.
+	if (!prometheus_exporter.is_listening()) {
+		uint64_t collection_time = (uint64_t)(Time::get_singleton()->get_unix_time_from_system() * 1000000000ULL);
+		EngineMetrics::observe(engine_metric_groups, metric_views, metric_aggregator, collection_time);
+		ObserveDroppedSpans(std::atomic_load(&span_rate_limiter), collection_time);
+		sdk_metrics.observe(metric_views, metric_aggregator, collection_time);
+		overhead_budget.observe(metric_views, metric_aggregator, collection_time);
+
+		std::vector<MetricPoint> points;
+		metric_aggregator.collect(collection_time, points);
+		if (!points.empty()) {
 			Dictionary root;
 			Array resourceMetrics;
 			Dictionary resourceMetric;
-			resourceMetric["resource"] = resource_attributes;
+			resourceMetric["resource"] = resource;
 
 			Array scopeMetrics;
 			Dictionary scopeMetric;
@@ -588,20 +2132,19 @@ void OpenTelemetry::FlushAllBufferedData() {
 			scope_dict["version"] = "1.0.0";
 			scopeMetric["scope"] = scope_dict;
 
+			// One OTLP Metric per instrument, holding all of its series.
+			// Arrays are shared, so data points can be appended after the
+			// metric is in place.
 			Array metricsArray;
-			for (size_t i = 0; i < metrics_result->RowCount(); i++) {
-				Dictionary metric;
-				metric["name"] = String(metrics_result->GetValue(0, i).GetValue<std::string>().c_str());
-				metric["value"] = metrics_result->GetValue(1, i).GetValue<double>();
-				metric["unit"] = String(metrics_result->GetValue(2, i).GetValue<std::string>().c_str());
-				metric["type"] = metrics_result->GetValue(3, i).GetValue<int32_t>();
-				metric["timestamp"] = metrics_result->GetValue(4, i).GetValue<uint64_t>();
-
-				JSON json;
-				String attributes_json = String(metrics_result->GetValue(5, i).GetValue<std::string>().c_str());
-				metric["attributes"] = json.parse_string(attributes_json);
-
-				metricsArray.push_back(metric);
+			std::unordered_map<std::string, Array> data_points;
+			for (const MetricPoint &point : points) {
+				auto it = data_points.find(point.name);
+				if (it == data_points.end()) {
+					Array metric_data_points;
+					metricsArray.push_back(MetricPointToOtlpMetric(point, metric_data_points));
+					it = data_points.emplace(point.name, metric_data_points).first;
+				}
+				it->second.push_back(MetricPointToOtlpDataPoint(point));
 			}
 			scopeMetric["metrics"] = metricsArray;
 
@@ -613,10 +2156,9 @@ void OpenTelemetry::FlushAllBufferedData() {
 
 			JSON json;
 			String jsonPayload = json.stringify(root);
-			http->request(HTTPClient::Method::METHOD_POST, "/v1/metrics", headers_array, jsonPayload);
-
-			// Clear metrics table
-			conn->Query("DELETE FROM metrics");
+			// Collected points are not kept for a retry: cumulative
+			// series are resent with the next collection anyway.
+			ExportBatch(OtlpHttpExporter::SIGNAL_METRICS, headers_array, jsonPayload, points.size(), false);
 		}
 	}
 
@@ -627,7 +2169,7 @@ void OpenTelemetry::FlushAllBufferedData() {
 			Dictionary root;
 			Array resourceLogs;
 			Dictionary resourceLog;
-			resourceLog["resource"] = resource_attributes;
+			resourceLog["resource"] = resource;
 
 			Array scopeLogs;
 			Dictionary scopeLog;
@@ -639,13 +2181,37 @@ void OpenTelemetry::FlushAllBufferedData() {
 			Array logRecordsArray;
 			for (size_t i = 0; i < logs_result->RowCount(); i++) {
 				Dictionary log_record;
-				log_record["level"] = String(logs_result->GetValue(0, i).GetValue<std::string>().c_str());
-				log_record["message"] = String(logs_result->GetValue(1, i).GetValue<std::string>().c_str());
-				log_record["timestamp"] = logs_result->GetValue(2, i).GetValue<uint64_t>();
+				uint64_t timestamp = logs_result->GetValue(2, i).GetValue<uint64_t>();
+				log_record["timeUnixNano"] = otlp_uint64(timestamp);
+				log_record["observedTimeUnixNano"] = otlp_uint64(timestamp);
+				log_record["severityText"] = String::utf8(logs_result->GetValue(0, i).GetValue<std::string>().c_str());
+				log_record["severityNumber"] = logs_result->GetValue(4, i).GetValue<int32_t>();
+				duckdb::Value log_trace_id = logs_result->GetValue(5, i);
+				if (!log_trace_id.IsNull()) {
+					log_record["traceId"] = log_context_id_to_hex(log_trace_id);
+					log_record["spanId"] = log_context_id_to_hex(logs_result->GetValue(6, i));
+				}
+				log_record["flags"] = logs_result->GetValue(7, i).GetValue<int32_t>();
 
 				JSON json;
-				String attributes_json = String(logs_result->GetValue(3, i).GetValue<std::string>().c_str());
-				log_record["attributes"] = json.parse_string(attributes_json);
+				String attributes_json = String::utf8(logs_result->GetValue(3, i).GetValue<std::string>().c_str());
+				Dictionary attributes = json.parse_string(attributes_json);
+				String message = String::utf8(logs_result->GetValue(1, i).GetValue<std::string>().c_str());
+
+				// Templated records are rendered only now. The template is
+				// kept as an attribute so backends can group by it.
+				duckdb::Value template_args = logs_result->GetValue(8, i);
+				if (!template_args.IsNull()) {
+					String log_template = message;
+					Variant args = UtilityFunctions::str_to_var(String::utf8(duckdb::StringValue::Get(template_args).c_str()));
+					message = log_template.format(args);
+					attributes["godot.log.template"] = log_template;
+				}
+
+				Dictionary body;
+				body["stringValue"] = message;
+				log_record["body"] = body;
+				log_record["attributes"] = make_otlp_attributes(attributes);
 
 				logRecordsArray.push_back(log_record);
 			}
@@ -659,19 +2225,64 @@ void OpenTelemetry::FlushAllBufferedData() {
 
 			JSON json;
 			String jsonPayload = json.stringify(root);
-			http->request(HTTPClient::Method::METHOD_POST, "/v1/logs", headers_array, jsonPayload);
 
-			// Clear logs table
+			ExportBatch(OtlpHttpExporter::SIGNAL_LOGS, headers_array, jsonPayload, logs_result->RowCount(), true);
 			conn->Query("DELETE FROM logs");
 		}
 	}
 
+	// Whatever is still buffered or waiting for the export thread after
+	// the flush, for the self metrics.
+	sdk_metrics.set_pending(OtlpHttpExporter::SIGNAL_TRACES, conn->Query("SELECT COUNT(*) FROM spans")->GetValue(0, 0).GetValue<int64_t>() + otlp_exporter.get_queued_items(OtlpHttpExporter::SIGNAL_TRACES));
+	sdk_metrics.set_pending(OtlpHttpExporter::SIGNAL_LOGS, conn->Query("SELECT COUNT(*) FROM logs")->GetValue(0, 0).GetValue<int64_t>() + otlp_exporter.get_queued_items(OtlpHttpExporter::SIGNAL_LOGS));
+	sdk_metrics.set_buffer_memory(duckdb::BufferManager::GetBufferManager(*db->instance).GetUsedMemory());
+
 	last_flush_time = current_time;
 }
 
+void OpenTelemetry::ExportBatch(OtlpHttpExporter::Signal signal, const PackedStringArray& headers, const String& payload, uint64_t items, bool can_retry) {
+	OtlpHttpExporter::Batch batch;
+	batch.signal = signal;
+	batch.headers = headers;
+	batch.body = payload.to_utf8_buffer();
+	batch.items = items;
+	batch.can_retry = can_retry;
+	if (!otlp_exporter.enqueue(std::move(batch))) {
+		sdk_metrics.add_dropped(signal, SdkMetrics::DROP_QUEUE_FULL, items);
+	}
+}
+
+void OpenTelemetry::RecordExport(const OtlpHttpExporter::Batch& batch, const OtlpHttpExporter::Response& response, uint64_t duration_usec, bool retry) {
+	// Runs on the export thread; both sinks are thread-safe.
+	sdk_metrics.record_export(batch.signal, response, batch.items, duration_usec, retry);
+
+	std::shared_ptr<const MetricStream> stream = metric_views.resolve(SdkMetrics::EXPORT_DURATION_METRIC, MetricAggregator::METRIC_TYPE_HISTOGRAM);
+	if (!stream->drop && duration_usec > 0) {
+		uint64_t time = (uint64_t)(Time::get_singleton()->get_unix_time_from_system() * 1000000000ULL);
+		metric_aggregator.record(*stream, "s", SdkMetrics::get_exporter_attributes(batch.signal), duration_usec / 1000000.0, time);
+	}
+}
+
 char* OpenTelemetry::Shutdown() {
+	DisableFrameProfiler();
+	CaptureEngineLogs(false, false);
+	{
+		// Traces still waiting for a tail sampling decision get one now.
+		std::lock_guard<std::mutex> lock(db_mutex);
+		if (conn && tail_sampler.is_enabled()) {
+			tail_sampler.decide(*conn, (uint64_t)(Time::get_singleton()->get_unix_time_from_system() * 1000000000ULL), true);
+		}
+	}
+	CollectLogSummaries(true);
 	FlushAllBufferedData(); // Flush any remaining buffered data
+	StopPrometheusExporter();
+	otlp_exporter.close();
+	overhead_budget.configure(0.0);
+	SetEngineMetrics(0);
 	active_spans.clear();
+	sdk_metrics.set_live_spans(0);
+	metric_aggregator.clear();
+	insert_log_statement.reset();
 	conn.reset();
 	db.reset();
 	return strdup("OK");
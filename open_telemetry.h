@@ -37,6 +37,7 @@
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/core/method_bind.hpp>
 #include <godot_cpp/templates/cowdata.hpp>
+#include <godot_cpp/templates/hash_map.hpp>
 #include <godot_cpp/templates/vector.hpp>
 #include <godot_cpp/variant/dictionary.hpp>
 #include <godot_cpp/variant/packed_byte_array.hpp>
@@ -46,22 +47,108 @@
 #include <godot_cpp/classes/time.hpp>
 #include <godot_cpp/classes/http_client.hpp>
 #include <godot_cpp/classes/tls_options.hpp>
+#include <atomic>
 #include <mutex>
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include "duckdb.hpp"
+#include "baggage.h"
+#include "engine_logger.h"
+#include "engine_metrics.h"
+#include "frame_profiler.h"
+#include "log_dedup.h"
+#include "log_severity.h"
+#include "metric_aggregator.h"
+#include "metric_view.h"
+#include "otlp_http_exporter.h"
+#include "overhead_budget.h"
+#include "prometheus_exporter.h"
+#include "sampler.h"
+#include "sdk_metrics.h"
+#include "span_scope.h"
+#include "trace_state.h"
+#include "tail_sampler.h"
+#include "trace_context.h"
 
 namespace godot {
 
 class OpenTelemetry : public RefCounted {
 	GDCLASS(OpenTelemetry, RefCounted);
 
+public:
+	enum MetricType {
+		METRIC_TYPE_GAUGE = MetricAggregator::METRIC_TYPE_GAUGE,
+		METRIC_TYPE_COUNTER = MetricAggregator::METRIC_TYPE_COUNTER,
+		METRIC_TYPE_UP_DOWN_COUNTER = MetricAggregator::METRIC_TYPE_UP_DOWN_COUNTER,
+		METRIC_TYPE_HISTOGRAM = MetricAggregator::METRIC_TYPE_HISTOGRAM,
+		METRIC_TYPE_SKETCH = MetricAggregator::METRIC_TYPE_SKETCH,
+	};
+
+	enum MetricTemporality {
+		METRIC_TEMPORALITY_DELTA = MetricAggregator::TEMPORALITY_DELTA,
+		METRIC_TEMPORALITY_CUMULATIVE = MetricAggregator::TEMPORALITY_CUMULATIVE,
+	};
+
+	enum ExemplarFilter {
+		EXEMPLAR_FILTER_ALWAYS_OFF = MetricAggregator::EXEMPLAR_FILTER_ALWAYS_OFF,
+		EXEMPLAR_FILTER_ALWAYS_ON = MetricAggregator::EXEMPLAR_FILTER_ALWAYS_ON,
+		EXEMPLAR_FILTER_TRACE_BASED = MetricAggregator::EXEMPLAR_FILTER_TRACE_BASED,
+	};
+
+	enum MetricAggregation {
+		METRIC_AGGREGATION_DEFAULT = MetricViewRegistry::AGGREGATION_DEFAULT,
+		METRIC_AGGREGATION_DROP = MetricViewRegistry::AGGREGATION_DROP,
+		METRIC_AGGREGATION_SUM = MetricViewRegistry::AGGREGATION_SUM,
+		METRIC_AGGREGATION_LAST_VALUE = MetricViewRegistry::AGGREGATION_LAST_VALUE,
+		METRIC_AGGREGATION_EXPLICIT_BUCKET_HISTOGRAM = MetricViewRegistry::AGGREGATION_EXPLICIT_BUCKET_HISTOGRAM,
+		METRIC_AGGREGATION_SKETCH = MetricViewRegistry::AGGREGATION_SKETCH,
+	};
+
+	enum EngineMetricGroup {
+		ENGINE_METRICS_TIME = EngineMetrics::GROUP_TIME,
+		ENGINE_METRICS_MEMORY = EngineMetrics::GROUP_MEMORY,
+		ENGINE_METRICS_OBJECTS = EngineMetrics::GROUP_OBJECTS,
+		ENGINE_METRICS_RENDER = EngineMetrics::GROUP_RENDER,
+		ENGINE_METRICS_PHYSICS = EngineMetrics::GROUP_PHYSICS,
+		ENGINE_METRICS_NAVIGATION = EngineMetrics::GROUP_NAVIGATION,
+	};
+
+	// Mirrors the OTEL_TRACES_SAMPLER values of the SDK configuration.
+	enum SamplerType {
+		SAMPLER_ALWAYS_ON = 0,
+		SAMPLER_ALWAYS_OFF = 1,
+		SAMPLER_TRACE_ID_RATIO = 2,
+		SAMPLER_PARENT_BASED_ALWAYS_ON = 3,
+		SAMPLER_PARENT_BASED_ALWAYS_OFF = 4,
+		SAMPLER_PARENT_BASED_TRACE_ID_RATIO = 5,
+	};
+
+	// OTLP SeverityNumber of the first value of each level.
+	enum LogSeverityLevel {
+		LOG_SEVERITY_UNSPECIFIED = LogSeverity::SEVERITY_UNSPECIFIED,
+		LOG_SEVERITY_TRACE = LogSeverity::SEVERITY_TRACE,
+		LOG_SEVERITY_DEBUG = LogSeverity::SEVERITY_DEBUG,
+		LOG_SEVERITY_INFO = LogSeverity::SEVERITY_INFO,
+		LOG_SEVERITY_WARN = LogSeverity::SEVERITY_WARN,
+		LOG_SEVERITY_ERROR = LogSeverity::SEVERITY_ERROR,
+		LOG_SEVERITY_FATAL = LogSeverity::SEVERITY_FATAL,
+	};
+
+	enum DegradationLevel {
+		DEGRADATION_NONE = OverheadBudget::LEVEL_NONE,
+		DEGRADATION_NO_DEBUG_LOGS = OverheadBudget::LEVEL_NO_DEBUG_LOGS,
+		DEGRADATION_AGGREGATED_METRICS = OverheadBudget::LEVEL_AGGREGATED_METRICS,
+		DEGRADATION_SAMPLED_TRACES = OverheadBudget::LEVEL_SAMPLED_TRACES,
+	};
+
 private:
 	// Global state (moved from wrapper)
 	String hostname;
 	Dictionary resource_attributes;
 	Dictionary headers;
 	Dictionary active_spans;
-	String trace_id;
 	String tracer_name;
 	int flush_interval_ms;
 	int batch_size;
@@ -69,6 +156,48 @@ private:
 	std::unique_ptr<duckdb::DuckDB> db;
 	std::unique_ptr<duckdb::Connection> conn;
 	std::mutex db_mutex;
+	MetricAggregator metric_aggregator;
+	MetricViewRegistry metric_views;
+	uint32_t engine_metric_groups;
+	PrometheusExporter prometheus_exporter;
+	// Temporality to restore once the Prometheus exporter stops.
+	int prometheus_previous_temporality;
+	// Sends serialized batches on its own thread, outside db_mutex.
+	OtlpHttpExporter otlp_exporter;
+	SdkMetrics sdk_metrics;
+	OverheadBudget overhead_budget;
+	// Applied to new traces at DEGRADATION_SAMPLED_TRACES, before `sampler`.
+	std::shared_ptr<Sampler> overhead_sampler;
+	// `sampler` is what span creation consults: `head_sampler`, wrapped in
+	// a RateLimitingSampler while a span rate limit is set.
+	std::shared_ptr<Sampler> sampler;
+	std::shared_ptr<Sampler> head_sampler;
+	std::shared_ptr<SpanRateLimiter> span_rate_limiter;
+	std::mutex sampler_mutex;
+	// Baggage of active spans, keyed by span id. Children share their
+	// parent's Baggage until they change it.
+	std::unordered_map<std::string, Baggage> span_baggage;
+	bool baggage_span_attributes;
+	Ref<OpenTelemetryProfiler> frame_profiler;
+	bool frame_profiler_spans;
+	bool frame_profiler_metrics;
+	Ref<OpenTelemetryLogger> engine_logger;
+	std::shared_ptr<EngineLogQueue> engine_log_queue;
+	// Minimum log severities. They are read on every log call from any
+	// thread, so the per-logger overrides are replaced as a whole and the
+	// common case without overrides is a single atomic load.
+	std::atomic<int> min_log_severity;
+	std::atomic<bool> has_logger_min_log_severities;
+	std::shared_ptr<const HashMap<String, int>> logger_min_log_severities;
+	std::mutex log_severity_mutex;
+	// Guarded by db_mutex, like the logs table they write to.
+	LogDeduplicator log_deduplicator;
+	std::unique_ptr<duckdb::PreparedStatement> insert_log_statement;
+	std::vector<std::string> baggage_attribute_keys;
+	TailSampler tail_sampler;
+	// Handle returned for spans dropped by the sampler. Operations on it
+	// return before doing any work.
+	String non_recording_span_id;
 
 protected:
 	static void _bind_methods();
@@ -80,7 +209,29 @@ public:
 	String init_tracer_provider(String p_name, String p_host, Dictionary p_attributes);
 	String set_headers(Dictionary p_headers);
 	String start_span(String p_name);
+	String start_root_span(String p_name);
+	void activate(String p_span_uuid);
+	void deactivate();
+	String get_current_span();
+	Ref<OpenTelemetryScope> activate_scope(String p_span_uuid);
 	String start_span_with_parent(String p_name, String p_parent_span_uuid);
+	String start_span_with_context(String p_name, Dictionary p_context);
+	PackedStringArray inject(String p_span_uuid, PackedStringArray p_headers);
+	Dictionary extract(PackedStringArray p_headers);
+	PackedByteArray inject_binary(String p_span_uuid);
+	void set_baggage(String p_span_uuid, String p_name, String p_value, String p_metadata);
+	String get_baggage(String p_span_uuid, String p_name);
+	Dictionary get_all_baggage(String p_span_uuid);
+	void remove_baggage(String p_span_uuid, String p_name);
+	void set_baggage_span_attributes(bool p_enabled, PackedStringArray p_keys);
+	String start_span_with_binary_context(String p_name, PackedByteArray p_context);
+	void set_sampler(int p_sampler, double p_ratio);
+	void set_span_rate_limit(double p_spans_per_second, int p_burst);
+	bool is_recording(String p_span_uuid);
+	String get_trace_state(String p_span_uuid);
+	static double get_adjusted_count(String p_trace_state);
+	void enable_tail_sampling(Dictionary p_policy);
+	void disable_tail_sampling();
 	String generate_uuid_v7();
 	void add_event(String p_span_uuid, String p_event_name);
 	void set_attributes(String p_span_uuid, Dictionary p_attributes);
@@ -88,33 +239,120 @@ public:
 	void end_span(String p_span_uuid);
 	void set_flush_interval(int p_interval_ms);
 	void set_batch_size(int p_size);
+	void set_export_timeout(int p_timeout_ms);
 	void record_metric(String p_name, float p_value, String p_unit, int p_metric_type, Dictionary p_attributes);
-	void log_message(String p_level, String p_message, Dictionary p_attributes);
+	void set_metric_temporality(int p_temporality);
+	void set_cardinality_limit(int p_limit);
+	void set_instrument_cardinality_limit(String p_name, int p_limit);
+	void set_exemplar_filter(int p_filter);
+	void set_exemplar_reservoir_size(int p_size);
+	void set_sketch_relative_accuracy(double p_relative_accuracy);
+	void set_sketch_max_buckets(int p_max_buckets);
+	void set_sketch_quantiles(Array p_quantiles);
+	void add_metric_view(String p_instrument_name, Dictionary p_view);
+	void clear_metric_views();
+	void set_engine_metrics(int p_groups);
+	int start_prometheus_exporter(int p_port, String p_bind_address);
+	void stop_prometheus_exporter();
+	int enable_frame_profiler(Dictionary p_options);
+	void disable_frame_profiler();
+	void log_message(String p_level, String p_message, Dictionary p_attributes, String p_span_uuid);
+	void log_template(String p_level, String p_template, Array p_args, Dictionary p_attributes, String p_span_uuid);
+	void emit_log(int p_severity, String p_message, Dictionary p_attributes, String p_logger_name, String p_span_uuid);
+	bool is_log_enabled(int p_severity, String p_logger_name);
+	void set_log_deduplication(double p_window_sec, double p_records_per_second, int p_burst);
+	void set_min_log_severity(int p_severity, String p_logger_name);
+	int get_min_log_severity(String p_logger_name);
+	void capture_engine_logs(bool p_enabled, bool p_include_print);
+	void set_overhead_budget(double p_budget_ms, double p_sampling_ratio);
+	int get_degradation_level();
+	Dictionary get_stats();
 	void flush_all();
 	String shutdown();
 
 private:
-	String start_span_with_id(String p_name, String p_span_id);
-	String start_span_with_parent_id(String p_name, String p_parent_span_uuid, String p_span_id);
+	String start_span_with_id(String p_name, String p_span_id, String p_trace_id, const std::string &p_trace_state);
+	String start_span_with_parent_id(String p_name, String p_parent_span_uuid, String p_span_id, String p_trace_id, const std::string &p_trace_state);
 
 	// Internal implementation methods (moved from wrapper)
 	char* InitTracerProvider(const char* name, const char* host, const char* json_attributes);
 	char* SetHeaders(const char* json_headers);
-	char* StartSpanWithId(const char* name, const char* span_id);
-	char* StartSpanWithParentWithId(const char* name, const char* parent_span_uuid, const char* span_id);
+	char* StartSpanWithId(const char* name, const char* span_id, const char* trace_id, const char* trace_state);
+	char* StartSpanWithParentWithId(const char* name, const char* parent_span_uuid, const char* span_id, const char* trace_id, const char* trace_state);
+	String GenerateTraceId();
+	bool GetParentContext(const String& parent_span_uuid, SpanContext& parent);
+	SpanContext GetSpanContext(const String& span_uuid);
+	String StartSpanWithRemoteParent(const String& name, const SpanContext& parent);
+	Baggage GetBaggage(const std::string& span_uuid);
+	void SetBaggage(const std::string& span_uuid, const Baggage& baggage);
+	void AddBaggageAttributes(Dictionary& attributes, const Baggage& baggage);
+	void SetSampler(int sampler_type, double ratio);
+	void SetSpanRateLimit(double spans_per_second, int burst);
+	void PublishSampler();
+	void ObserveDroppedSpans(const std::shared_ptr<SpanRateLimiter>& limiter, uint64_t collection_time);
+	Sampler::Result ShouldSample(const SpanContext* parent, const String& trace_id, const char* name);
+	void EnableTailSampling(const TailSampler::Policy& policy);
+	void DisableTailSampling();
 	void AddEvent(const char* span_uuid, const char* event_name);
 	void SetAttributes(const char* span_uuid, const char* json_attributes);
 	void RecordError(const char* span_uuid, const char* error);
 	void EndSpan(const char* span_uuid);
+	void InsertSpan(const Dictionary& span);
+	void DisableFrameProfiler();
+	void RecordProfilerFrame(const OpenTelemetryProfiler::Frame& frame);
+	void RecordFrameHistogram(const char* name, double value, const std::string& attributes, uint64_t time);
 	void SetFlushInterval(int interval_ms);
 	void SetBatchSize(int size);
-	void RecordMetric(const char* name, double value, const char* unit, int metric_type, const char* json_attributes);
-	void LogMessage(const char* level, const char* message, const char* json_attributes);
+	void RecordMetric(const MetricStream& stream, double value, const char* unit, const char* json_attributes);
+	void SetMetricTemporality(int temporality);
+	void SetCardinalityLimit(int limit);
+	void SetInstrumentCardinalityLimit(const char* name, int limit);
+	void SetExemplarFilter(int filter);
+	void SetExemplarReservoirSize(int size);
+	void SetSketchRelativeAccuracy(double relative_accuracy);
+	void SetSketchMaxBuckets(int max_buckets);
+	void SetSketchQuantiles(const std::vector<double>& quantiles);
+	void AddMetricView(const MetricView& view);
+	void ClearMetricViews();
+	void SetEngineMetrics(int groups);
+	int StartPrometheusExporter(int port, const String& bind_address);
+	void StopPrometheusExporter();
+	std::string RenderOpenMetrics();
+	void UpdateProcessFrameConnection();
+	void _on_process_frame();
+	static Dictionary MetricPointToOtlpMetric(const MetricPoint& point, const Array& data_points);
+	static Dictionary MetricPointToOtlpDataPoint(const MetricPoint& point);
+	bool IsLogEnabled(int severity_number, const String& logger_name);
+	int GetMinLogSeverity(const String& logger_name);
+	void SetMinLogSeverity(int severity_number, const String& logger_name);
+	bool IsLogShed(int severity_number);
+	int GetEngineLogMinSeverity();
+	bool GetLogSpanContext(const String& span_uuid, SpanContext& context);
+	void LogMessage(int severity_number, const char* level, const char* message, const char* json_attributes, const char* template_args, const SpanContext& context);
+	bool WriteLogRecord(const LogRecordData& record);
+	void InsertLogRecord(const LogRecordData& record);
+	void SetLogDeduplication(double window_sec, double records_per_second, int burst);
+	void CollectLogSummaries(bool all);
+	void CaptureEngineLogs(bool enabled, bool include_print);
+	void DrainEngineLogs();
+	void SetOverheadBudget(double budget_ms, double sampling_ratio);
+	void ApplyDegradationLevel();
 	void CheckAndFlush();
 	void FlushAllBufferedData();
+	void ExportBatch(OtlpHttpExporter::Signal signal, const PackedStringArray& headers, const String& payload, uint64_t items, bool can_retry);
+	void RecordExport(const OtlpHttpExporter::Batch& batch, const OtlpHttpExporter::Response& response, uint64_t duration_usec, bool retry);
 	char* Shutdown();
 };
 
 }
 
+VARIANT_ENUM_CAST(OpenTelemetry::MetricType);
+VARIANT_ENUM_CAST(OpenTelemetry::MetricTemporality);
+VARIANT_ENUM_CAST(OpenTelemetry::ExemplarFilter);
+VARIANT_ENUM_CAST(OpenTelemetry::MetricAggregation);
+VARIANT_ENUM_CAST(OpenTelemetry::EngineMetricGroup);
+VARIANT_ENUM_CAST(OpenTelemetry::SamplerType);
+VARIANT_ENUM_CAST(OpenTelemetry::LogSeverityLevel);
+VARIANT_ENUM_CAST(OpenTelemetry::DegradationLevel);
+
 #endif // OPEN_TELEMETRY_H
@@ -0,0 +1,396 @@
+/**************************************************************************/
+/*  openmetrics_writer.cpp                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "openmetrics_writer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace godot;
+
+const char *OpenMetricsWriter::CONTENT_TYPE = "application/openmetrics-text; version=1.0.0; charset=utf-8";
+
+namespace {
+
+std::string format_double(double p_value) {
+	if (std::isnan(p_value)) {
+		return "NaN";
+	}
+	if (std::isinf(p_value)) {
+		return p_value > 0 ? "+Inf" : "-Inf";
+	}
+	// Shortest representation that still round-trips, so label values such
+	// as le="0.1" or quantile="0.99" stay readable.
+	char buffer[32];
+	snprintf(buffer, sizeof(buffer), "%.15g", p_value);
+	if (strtod(buffer, nullptr) != p_value) {
+		snprintf(buffer, sizeof(buffer), "%.17g", p_value);
+	}
+	return buffer;
+}
+
+void append_utf8(std::string &r_string, uint32_t p_codepoint) {
+	if (p_codepoint < 0x80) {
+		r_string += (char)p_codepoint;
+	} else if (p_codepoint < 0x800) {
+		r_string += (char)(0xC0 | (p_codepoint >> 6));
+		r_string += (char)(0x80 | (p_codepoint & 0x3F));
+	} else if (p_codepoint < 0x10000) {
+		r_string += (char)(0xE0 | (p_codepoint >> 12));
+		r_string += (char)(0x80 | ((p_codepoint >> 6) & 0x3F));
+		r_string += (char)(0x80 | (p_codepoint & 0x3F));
+	} else {
+		r_string += (char)(0xF0 | (p_codepoint >> 18));
+		r_string += (char)(0x80 | ((p_codepoint >> 12) & 0x3F));
+		r_string += (char)(0x80 | ((p_codepoint >> 6) & 0x3F));
+		r_string += (char)(0x80 | (p_codepoint & 0x3F));
+	}
+}
+
+uint32_t read_hex4(const std::string &p_json, size_t p_pos) {
+	uint32_t value = 0;
+	for (size_t i = p_pos; i < p_pos + 4 && i < p_json.size(); i++) {
+		char c = p_json[i];
+		value <<= 4;
+		if (c >= '0' && c <= '9') {
+			value |= c - '0';
+		} else if (c >= 'a' && c <= 'f') {
+			value |= c - 'a' + 10;
+		} else if (c >= 'A' && c <= 'F') {
+			value |= c - 'A' + 10;
+		}
+	}
+	return value;
+}
+
+// Reads a JSON string starting at the opening quote and leaves r_pos after
+// the closing quote.
+std::string read_json_string(const std::string &p_json, size_t &r_pos) {
+	std::string result;
+	r_pos++;
+	while (r_pos < p_json.size() && p_json[r_pos] != '"') {
+		char c = p_json[r_pos++];
+		if (c != '\\' || r_pos >= p_json.size()) {
+			result += c;
+			continue;
+		}
+		char escape = p_json[r_pos++];
+		switch (escape) {
+			case 'b':
+				result += '\b';
+				break;
+			case 'f':
+				result += '\f';
+				break;
+			case 'n':
+				result += '\n';
+				break;
+			case 'r':
+				result += '\r';
+				break;
+			case 't':
+				result += '\t';
+				break;
+			case 'u': {
+				uint32_t codepoint = read_hex4(p_json, r_pos);
+				r_pos += 4;
+				if (codepoint >= 0xD800 && codepoint < 0xDC00 && r_pos + 6 <= p_json.size() && p_json[r_pos] == '\\' && p_json[r_pos + 1] == 'u') {
+					uint32_t low = read_hex4(p_json, r_pos + 2);
+					r_pos += 6;
+					codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+				}
+				append_utf8(result, codepoint);
+			} break;
+			default:
+				result += escape;
+				break;
+		}
+	}
+	r_pos++;
+	return result;
+}
+
+void skip_whitespace(const std::string &p_json, size_t &r_pos) {
+	while (r_pos < p_json.size() && (p_json[r_pos] == ' ' || p_json[r_pos] == '\n' || p_json[r_pos] == '\r' || p_json[r_pos] == '\t')) {
+		r_pos++;
+	}
+}
+
+} // namespace
+
+std::string OpenMetricsWriter::sanitize_metric_name(const std::string &p_name) {
+	std::string result = p_name;
+	for (size_t i = 0; i < result.size(); i++) {
+		char c = result[i];
+		bool valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c == ':' || (i > 0 && c >= '0' && c <= '9');
+		if (!valid) {
+			result[i] = '_';
+		}
+	}
+	return result.empty() ? std::string("_") : result;
+}
+
+std::string OpenMetricsWriter::sanitize_label_name(const std::string &p_name) {
+	std::string result = p_name;
+	for (size_t i = 0; i < result.size(); i++) {
+		char c = result[i];
+		bool valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || (i > 0 && c >= '0' && c <= '9');
+		if (!valid) {
+			result[i] = '_';
+		}
+	}
+	return result.empty() ? std::string("_") : result;
+}
+
+void OpenMetricsWriter::parse_attributes(const std::string &p_json, std::vector<std::pair<std::string, std::string>> &r_labels) {
+	// Attributes are stored as a flat JSON object. String values become the
+	// label value as-is; any other value keeps its JSON text.
+	size_t pos = 0;
+	skip_whitespace(p_json, pos);
+	if (pos >= p_json.size() || p_json[pos] != '{') {
+		return;
+	}
+	pos++;
+	while (pos < p_json.size()) {
+		skip_whitespace(p_json, pos);
+		if (pos >= p_json.size() || p_json[pos] != '"') {
+			return;
+		}
+		std::string key = read_json_string(p_json, pos);
+		skip_whitespace(p_json, pos);
+		if (pos >= p_json.size() || p_json[pos] != ':') {
+			return;
+		}
+		pos++;
+		skip_whitespace(p_json, pos);
+
+		std::string value;
+		if (pos < p_json.size() && p_json[pos] == '"') {
+			value = read_json_string(p_json, pos);
+		} else {
+			size_t start = pos;
+			int depth = 0;
+			bool in_string = false;
+			for (; pos < p_json.size(); pos++) {
+				char c = p_json[pos];
+				if (in_string) {
+					if (c == '\\') {
+						pos++;
+					} else if (c == '"') {
+						in_string = false;
+					}
+				} else if (c == '"') {
+					in_string = true;
+				} else if (c == '[' || c == '{') {
+					depth++;
+				} else if (c == ']' || c == '}') {
+					if (depth == 0) {
+						break;
+					}
+					depth--;
+				} else if (c == ',' && depth == 0) {
+					break;
+				}
+			}
+			value = p_json.substr(start, pos - start);
+			while (!value.empty() && (value.back() == ' ' || value.back() == '\n' || value.back() == '\t' || value.back() == '\r')) {
+				value.pop_back();
+			}
+		}
+		r_labels.emplace_back(sanitize_label_name(key), value);
+
+		skip_whitespace(p_json, pos);
+		if (pos < p_json.size() && p_json[pos] == ',') {
+			pos++;
+			continue;
+		}
+		return;
+	}
+}
+
+void OpenMetricsWriter::append_labels(const std::vector<std::pair<std::string, std::string>> &p_labels, const char *p_extra_name, const std::string &p_extra_value) {
+	if (p_labels.empty() && !p_extra_name) {
+		return;
+	}
+	text += '{';
+	bool first = true;
+	auto append_label = [&](const std::string &p_name, const std::string &p_value) {
+		if (!first) {
+			text += ',';
+		}
+		first = false;
+		text += p_name;
+		text += "=\"";
+		for (char c : p_value) {
+			if (c == '\\') {
+				text += "\\\\";
+			} else if (c == '"') {
+				text += "\\\"";
+			} else if (c == '\n') {
+				text += "\\n";
+			} else {
+				text += c;
+			}
+		}
+		text += '"';
+	};
+	for (const std::pair<std::string, std::string> &label : p_labels) {
+		append_label(label.first, label.second);
+	}
+	if (p_extra_name) {
+		append_label(p_extra_name, p_extra_value);
+	}
+	text += '}';
+}
+
+void OpenMetricsWriter::append_value(double p_value) {
+	text += ' ';
+	text += format_double(p_value);
+}
+
+void OpenMetricsWriter::append_exemplar(const MetricExemplar &p_exemplar) {
+	text += " # {";
+	if (!p_exemplar.trace_id.empty()) {
+		text += "trace_id=\"" + p_exemplar.trace_id + "\",span_id=\"" + p_exemplar.span_id + "\"";
+	}
+	text += '}';
+	append_value(p_exemplar.value);
+	char timestamp[32];
+	snprintf(timestamp, sizeof(timestamp), " %.3f", (double)p_exemplar.time_unix_nano / 1000000000.0);
+	text += timestamp;
+}
+
+void OpenMetricsWriter::write_family(const std::string &p_name, const std::vector<MetricPoint> &p_points) {
+	if (p_points.empty()) {
+		return;
+	}
+	std::string family = sanitize_metric_name(p_name);
+	int type = p_points[0].type;
+
+	std::vector<std::pair<std::string, std::string>> labels;
+	switch (type) {
+		case MetricAggregator::METRIC_TYPE_COUNTER: {
+			static const std::string total_suffix = "_total";
+			if (family.size() > total_suffix.size() && family.compare(family.size() - total_suffix.size(), total_suffix.size(), total_suffix) == 0) {
+				family.resize(family.size() - total_suffix.size());
+			}
+			text += "# TYPE " + family + " counter\n";
+			for (const MetricPoint &point : p_points) {
+				labels.clear();
+				parse_attributes(point.attributes, labels);
+				text += family + "_total";
+				append_labels(labels);
+				append_value(point.value);
+				if (!point.exemplars.empty()) {
+					append_exemplar(point.exemplars.back());
+				}
+				text += '\n';
+			}
+		} break;
+		case MetricAggregator::METRIC_TYPE_HISTOGRAM: {
+			text += "# TYPE " + family + " histogram\n";
+			for (const MetricPoint &point : p_points) {
+				labels.clear();
+				parse_attributes(point.attributes, labels);
+
+				// Exemplars only carry their value, so each one is placed on
+				// the bucket it was counted in, with the same upper-inclusive
+				// lookup as the aggregator.
+				std::vector<const MetricExemplar *> bucket_exemplars(point.bucket_counts.size(), nullptr);
+				for (const MetricExemplar &exemplar : point.exemplars) {
+					size_t bucket = std::lower_bound(point.bucket_bounds.begin(), point.bucket_bounds.end(), exemplar.value) - point.bucket_bounds.begin();
+					if (bucket < bucket_exemplars.size()) {
+						bucket_exemplars[bucket] = &exemplar;
+					}
+				}
+
+				// OpenMetrics buckets are cumulative, OTLP buckets are not.
+				uint64_t cumulative = 0;
+				for (size_t i = 0; i < point.bucket_counts.size(); i++) {
+					cumulative += point.bucket_counts[i];
+					bool is_last = i >= point.bucket_bounds.size();
+					text += family + "_bucket";
+					append_labels(labels, "le", is_last ? std::string("+Inf") : format_double(point.bucket_bounds[i]));
+					append_value((double)cumulative);
+					if (bucket_exemplars[i] != nullptr) {
+						append_exemplar(*bucket_exemplars[i]);
+					}
+					text += '\n';
+				}
+				text += family + "_count";
+				append_labels(labels);
+				append_value((double)point.count);
+				text += '\n';
+				text += family + "_sum";
+				append_labels(labels);
+				append_value(point.sum);
+				text += '\n';
+			}
+		} break;
+		case MetricAggregator::METRIC_TYPE_SKETCH: {
+			text += "# TYPE " + family + " summary\n";
+			for (const MetricPoint &point : p_points) {
+				labels.clear();
+				parse_attributes(point.attributes, labels);
+				for (size_t i = 0; i < point.quantiles.size(); i++) {
+					text += family;
+					append_labels(labels, "quantile", format_double(point.quantiles[i]));
+					append_value(point.quantile_values[i]);
+					text += '\n';
+				}
+				text += family + "_count";
+				append_labels(labels);
+				append_value((double)point.count);
+				text += '\n';
+				text += family + "_sum";
+				append_labels(labels);
+				append_value(point.sum);
+				text += '\n';
+			}
+		} break;
+		default: {
+			text += "# TYPE " + family + " gauge\n";
+			for (const MetricPoint &point : p_points) {
+				labels.clear();
+				parse_attributes(point.attributes, labels);
+				text += family;
+				append_labels(labels);
+				append_value(point.value);
+				text += '\n';
+			}
+		} break;
+	}
+}
+
+void OpenMetricsWriter::write_eof() {
+	text += "# EOF\n";
+}
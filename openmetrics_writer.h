@@ -0,0 +1,66 @@
+/**************************************************************************/
+/*  openmetrics_writer.h                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef OPENMETRICS_WRITER_H
+#define OPENMETRICS_WRITER_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "metric_aggregator.h"
+
+namespace godot {
+
+// Renders aggregated metric points in the OpenMetrics text exposition
+// format, one metric family at a time.
+class OpenMetricsWriter {
+	std::string text;
+
+	void append_labels(const std::vector<std::pair<std::string, std::string>> &p_labels, const char *p_extra_name = nullptr, const std::string &p_extra_value = std::string());
+	void append_value(double p_value);
+	void append_exemplar(const MetricExemplar &p_exemplar);
+
+public:
+	static const char *CONTENT_TYPE;
+
+	static std::string sanitize_metric_name(const std::string &p_name);
+	static std::string sanitize_label_name(const std::string &p_name);
+	static void parse_attributes(const std::string &p_json, std::vector<std::pair<std::string, std::string>> &r_labels);
+
+	void write_family(const std::string &p_name, const std::vector<MetricPoint> &p_points);
+	void write_eof();
+
+	const std::string &get_text() const { return text; }
+};
+
+} // namespace godot
+
+#endif // OPENMETRICS_WRITER_H
@@ -0,0 +1,332 @@
+/**************************************************************************/
+/*  otlp_http_exporter.cpp                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "otlp_http_exporter.h"
+
+#include <godot_cpp/classes/json.hpp>
+#include <godot_cpp/classes/os.hpp>
+#include <godot_cpp/classes/time.hpp>
+#include <godot_cpp/classes/tls_options.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+
+#include <chrono>
+#include <cstdlib>
+
+using namespace godot;
+
+static const char *signal_paths[OtlpHttpExporter::SIGNAL_MAX] = { "/v1/traces", "/v1/metrics", "/v1/logs" };
+static const char *rejected_keys[OtlpHttpExporter::SIGNAL_MAX] = { "rejectedSpans", "rejectedDataPoints", "rejectedLogRecords" };
+
+// Sleep between polls of a pending connection or response.
+static const int POLL_INTERVAL_USEC = 500;
+
+bool OtlpHttpExporter::parse_endpoint(const std::string &p_url, Endpoint &r_endpoint) {
+	Endpoint endpoint;
+	std::string rest = p_url;
+	size_t scheme_end = rest.find("://");
+	if (scheme_end != std::string::npos) {
+		std::string scheme = rest.substr(0, scheme_end);
+		if (scheme == "https") {
+			endpoint.tls = true;
+			endpoint.port = 443;
+		} else if (scheme == "http") {
+			endpoint.port = 80;
+		} else {
+			return false;
+		}
+		rest = rest.substr(scheme_end + 3);
+	}
+
+	size_t path_start = rest.find('/');
+	if (path_start != std::string::npos) {
+		endpoint.base_path = rest.substr(path_start);
+		while (!endpoint.base_path.empty() && endpoint.base_path.back() == '/') {
+			endpoint.base_path.pop_back();
+		}
+		rest.resize(path_start);
+	}
+
+	// A port follows the last colon, unless it is inside an IPv6 literal.
+	size_t colon = rest.rfind(':');
+	size_t bracket = rest.rfind(']');
+	if (colon != std::string::npos && (bracket == std::string::npos || colon > bracket)) {
+		std::string port = rest.substr(colon + 1);
+		char *end = nullptr;
+		long value = strtol(port.c_str(), &end, 10);
+		if (port.empty() || *end != '\0' || value <= 0 || value > 65535) {
+			return false;
+		}
+		endpoint.port = (int)value;
+		rest.resize(colon);
+	} else if (scheme_end == std::string::npos) {
+		endpoint.port = DEFAULT_PORT;
+	}
+	if (rest.size() > 2 && rest.front() == '[' && rest.back() == ']') {
+		rest = rest.substr(1, rest.size() - 2);
+	}
+	if (rest.empty()) {
+		return false;
+	}
+	endpoint.host = rest;
+	r_endpoint = endpoint;
+	return true;
+}
+
+void OtlpHttpExporter::configure(const String &p_url) {
+	close();
+	endpoint_valid = parse_endpoint(p_url.utf8().get_data(), endpoint);
+}
+
+void OtlpHttpExporter::set_timeout(int p_timeout_msec) {
+	timeout_msec.store(p_timeout_msec > 0 ? p_timeout_msec : DEFAULT_TIMEOUT_MSEC);
+}
+
+void OtlpHttpExporter::set_export_callback(const ExportCallback &p_callback) {
+	close();
+	export_callback = p_callback;
+}
+
+bool OtlpHttpExporter::enqueue(Batch &&p_batch) {
+	{
+		std::lock_guard<std::mutex> lock(queue_mutex);
+		if (stopping || queue.size() >= MAX_QUEUED_BATCHES) {
+			return false;
+		}
+		queued_items[p_batch.signal] += p_batch.items;
+		queue.push_back(std::move(p_batch));
+		if (!worker.joinable()) {
+			worker = std::thread(&OtlpHttpExporter::run, this);
+		}
+	}
+	queue_condition.notify_one();
+	return true;
+}
+
+uint64_t OtlpHttpExporter::get_queued_items(Signal p_signal) {
+	std::lock_guard<std::mutex> lock(queue_mutex);
+	return queued_items[p_signal];
+}
+
+void OtlpHttpExporter::run() {
+	uint64_t drain_deadline = 0;
+	std::unique_lock<std::mutex> lock(queue_mutex);
+	while (true) {
+		queue_condition.wait(lock, [this]() { return stopping || !queue.empty(); });
+		if (queue.empty()) {
+			break;
+		}
+		Batch batch = std::move(queue.front());
+		queue.pop_front();
+		bool give_up = false;
+		if (stopping) {
+			uint64_t now = Time::get_singleton()->get_ticks_msec();
+			if (drain_deadline == 0) {
+				drain_deadline = now + (uint64_t)timeout_msec.load();
+			}
+			give_up = now >= drain_deadline;
+		}
+		lock.unlock();
+
+		if (give_up) {
+			Response response;
+			response.error_message = "OTLP exporter closed before the batch was sent";
+			if (export_callback) {
+				export_callback(batch, response, 0, false);
+			}
+		} else {
+			export_batch(batch);
+		}
+
+		lock.lock();
+		queued_items[batch.signal] -= batch.items;
+	}
+}
+
+void OtlpHttpExporter::export_batch(Batch &r_batch) {
+	while (true) {
+		uint64_t start_usec = Time::get_singleton()->get_ticks_usec();
+		Response response = send(r_batch.signal, r_batch.headers, r_batch.body);
+		uint64_t duration_usec = Time::get_singleton()->get_ticks_usec() - start_usec;
+		r_batch.attempts++;
+
+		bool retry;
+		{
+			std::lock_guard<std::mutex> lock(queue_mutex);
+			retry = r_batch.can_retry && !response.is_success() && response.retryable && r_batch.attempts < MAX_ATTEMPTS && !stopping;
+		}
+		if (export_callback) {
+			export_callback(r_batch, response, duration_usec, retry);
+		}
+		if (!retry) {
+			return;
+		}
+
+		// close() cuts the backoff short; the batch then gets its last attempt.
+		std::chrono::milliseconds backoff(RETRY_BACKOFF_MSEC << (r_batch.attempts - 1));
+		std::unique_lock<std::mutex> lock(queue_mutex);
+		queue_condition.wait_for(lock, backoff, [this]() { return stopping; });
+	}
+}
+
+void OtlpHttpExporter::close() {
+	{
+		std::lock_guard<std::mutex> lock(queue_mutex);
+		stopping = true;
+	}
+	queue_condition.notify_all();
+	if (worker.joinable()) {
+		worker.join();
+	}
+	// Without a running worker the connection belongs to this thread again.
+	disconnect();
+	std::lock_guard<std::mutex> lock(queue_mutex);
+	stopping = false;
+}
+
+void OtlpHttpExporter::disconnect() {
+	if (client.is_valid()) {
+		client->close();
+		client.unref();
+	}
+}
+
+OtlpHttpExporter::~OtlpHttpExporter() {
+	close();
+}
+
+bool OtlpHttpExporter::connect(uint64_t p_deadline_msec) {
+	if (client.is_valid() && client->get_status() == HTTPClient::STATUS_CONNECTED) {
+		return true;
+	}
+	// Anything else is a dropped keep-alive connection or a previous
+	// failure; start over.
+	disconnect();
+	client.instantiate();
+	Ref<TLSOptions> tls = endpoint.tls ? TLSOptions::client() : Ref<TLSOptions>();
+	if (client->connect_to_host(String::utf8(endpoint.host.c_str()), endpoint.port, tls) != OK) {
+		return false;
+	}
+	while (true) {
+		client->poll();
+		HTTPClient::Status status = client->get_status();
+		if (status == HTTPClient::STATUS_CONNECTED) {
+			return true;
+		}
+		if (status != HTTPClient::STATUS_RESOLVING && status != HTTPClient::STATUS_CONNECTING) {
+			return false;
+		}
+		if (Time::get_singleton()->get_ticks_msec() >= p_deadline_msec) {
+			return false;
+		}
+		OS::get_singleton()->delay_usec(POLL_INTERVAL_USEC);
+	}
+}
+
+bool OtlpHttpExporter::is_retryable_status(int p_status) {
+	return p_status == 429 || p_status == 502 || p_status == 503 || p_status == 504;
+}
+
+void OtlpHttpExporter::parse_partial_success(const PackedByteArray &p_body, Response &r_response) {
+	if (p_body.is_empty()) {
+		return;
+	}
+	Variant parsed = JSON::parse_string(p_body.get_string_from_utf8());
+	if (parsed.get_type() != Variant::DICTIONARY) {
+		return;
+	}
+	Dictionary partial_success = Dictionary(parsed).get("partialSuccess", Dictionary());
+	for (const char *key : rejected_keys) {
+		// int64 values are strings in OTLP JSON.
+		Variant rejected = partial_success.get(key, Variant());
+		if (rejected.get_type() == Variant::STRING) {
+			r_response.rejected += String(rejected).to_int();
+		} else if (rejected.get_type() == Variant::INT || rejected.get_type() == Variant::FLOAT) {
+			r_response.rejected += (int64_t)rejected;
+		}
+	}
+	r_response.error_message = partial_success.get("errorMessage", String());
+}
+
+OtlpHttpExporter::Response OtlpHttpExporter::send(Signal p_signal, const PackedStringArray &p_headers, const PackedByteArray &p_body) {
+	Response response;
+	if (!endpoint_valid) {
+		response.error_message = "Invalid OTLP endpoint";
+		return response;
+	}
+	stats.requests++;
+	uint64_t deadline = Time::get_singleton()->get_ticks_msec() + (uint64_t)timeout_msec.load();
+	response.request_bytes = (uint64_t)p_body.size();
+	String url = String::utf8((endpoint.base_path + signal_paths[p_signal]).c_str());
+
+	bool sent = connect(deadline) && client->request_raw(HTTPClient::METHOD_POST, url, p_headers, p_body) == OK;
+	while (sent && client->get_status() == HTTPClient::STATUS_REQUESTING) {
+		if (Time::get_singleton()->get_ticks_msec() >= deadline) {
+			sent = false;
+			break;
+		}
+		OS::get_singleton()->delay_usec(POLL_INTERVAL_USEC);
+		client->poll();
+	}
+	if (!sent || !client->has_response()) {
+		stats.failed_requests++;
+		response.retryable = true;
+		response.error_message = "No response from the OTLP endpoint";
+		disconnect();
+		return response;
+	}
+	stats.bytes_sent += (uint64_t)p_body.size();
+	response.status = client->get_response_code();
+
+	PackedByteArray response_body;
+	while (client->get_status() == HTTPClient::STATUS_BODY) {
+		client->poll();
+		PackedByteArray chunk = client->read_response_body_chunk();
+		if (chunk.is_empty()) {
+			if (Time::get_singleton()->get_ticks_msec() >= deadline) {
+				// The status is known; only the body is lost.
+				disconnect();
+				break;
+			}
+			OS::get_singleton()->delay_usec(POLL_INTERVAL_USEC);
+		} else {
+			response_body.append_array(chunk);
+		}
+	}
+
+	if (response.is_success()) {
+		parse_partial_success(response_body, response);
+		stats.rejected_items += (uint64_t)response.rejected;
+	} else {
+		stats.failed_requests++;
+		response.retryable = is_retryable_status(response.status);
+		response.error_message = response_body.get_string_from_utf8();
+	}
+	return response;
+}
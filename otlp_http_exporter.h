@@ -0,0 +1,161 @@
+/**************************************************************************/
+/*  otlp_http_exporter.h                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef OTLP_HTTP_EXPORTER_H
+#define OTLP_HTTP_EXPORTER_H
+
+#include <godot_cpp/classes/http_client.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/packed_string_array.hpp>
+#include <godot_cpp/variant/string.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace godot {
+
+// Sends OTLP/HTTP requests to one collector endpoint and keeps the
+// connection alive between flushes. Batches are serialized by the caller
+// and queued; an export thread sends them in order, so flushing never
+// waits for the network.
+//
+// Following the OTLP/HTTP specification, 429, 502, 503 and 504 responses
+// and transport errors are retryable: the export thread sends the batch
+// again after a backoff, up to MAX_ATTEMPTS times. A 200 response may
+// carry a partial_success with the number of rejected items.
+class OtlpHttpExporter {
+public:
+	static const int DEFAULT_TIMEOUT_MSEC = 10000;
+	static const int DEFAULT_PORT = 4318;
+	static const int MAX_ATTEMPTS = 3;
+	static const int RETRY_BACKOFF_MSEC = 1000; // Doubles with each attempt.
+	static const size_t MAX_QUEUED_BATCHES = 64;
+
+	enum Signal {
+		SIGNAL_TRACES,
+		SIGNAL_METRICS,
+		SIGNAL_LOGS,
+		SIGNAL_MAX,
+	};
+
+	struct Endpoint {
+		bool tls = false;
+		std::string host;
+		int port = DEFAULT_PORT;
+		std::string base_path; // Without a trailing slash.
+	};
+
+	struct Response {
+		int status = 0; // 0 if no response was received.
+		bool retryable = false;
+		int64_t rejected = 0;
+		uint64_t request_bytes = 0; // Size of the request body.
+		String error_message;
+
+		bool is_success() const { return status >= 200 && status < 300; }
+	};
+
+	struct Stats {
+		uint64_t requests = 0;
+		uint64_t failed_requests = 0;
+		uint64_t bytes_sent = 0;
+		uint64_t rejected_items = 0;
+	};
+
+	// One serialized export request.
+	struct Batch {
+		Signal signal = SIGNAL_TRACES;
+		PackedStringArray headers;
+		PackedByteArray body;
+		uint64_t items = 0;
+		bool can_retry = false;
+		int attempts = 0;
+	};
+
+	// Called on the export thread after every attempt; `p_retry` tells
+	// whether the batch will be sent again.
+	typedef std::function<void(const Batch &p_batch, const Response &p_response, uint64_t p_duration_usec, bool p_retry)> ExportCallback;
+
+private:
+	Endpoint endpoint;
+	bool endpoint_valid = false;
+	std::atomic<int> timeout_msec{ DEFAULT_TIMEOUT_MSEC };
+	// Only used on the export thread while it runs.
+	Ref<HTTPClient> client;
+	Stats stats;
+
+	ExportCallback export_callback;
+	std::thread worker;
+	std::mutex queue_mutex;
+	std::condition_variable queue_condition;
+	std::deque<Batch> queue;
+	uint64_t queued_items[SIGNAL_MAX] = {};
+	bool stopping = false;
+
+	bool connect(uint64_t p_deadline_msec);
+	void disconnect();
+	static bool is_retryable_status(int p_status);
+	static void parse_partial_success(const PackedByteArray &p_body, Response &r_response);
+	Response send(Signal p_signal, const PackedStringArray &p_headers, const PackedByteArray &p_body);
+	void export_batch(Batch &r_batch);
+	void run();
+
+public:
+	// Accepts `host:port`, `http://host[:port][/path]` and
+	// `https://host[:port][/path]`. Without a scheme plain HTTP is used.
+	static bool parse_endpoint(const std::string &p_url, Endpoint &r_endpoint);
+
+	void configure(const String &p_url);
+	void set_timeout(int p_timeout_msec);
+	void set_export_callback(const ExportCallback &p_callback);
+	// Hands a batch to the export thread, starting it if needed. Returns
+	// false, without queueing, when MAX_QUEUED_BATCHES are already waiting
+	// or the exporter is closing.
+	bool enqueue(Batch &&p_batch);
+	// Items of `p_signal` queued and not yet sent.
+	uint64_t get_queued_items(Signal p_signal);
+	// Only consistent while the export thread is stopped.
+	const Stats &get_stats() const { return stats; }
+	// Sends what is queued, giving up on batches still waiting after one
+	// more timeout, then stops the export thread and closes the connection.
+	void close();
+
+	~OtlpHttpExporter();
+};
+
+} // namespace godot
+
+#endif // OTLP_HTTP_EXPORTER_H
@@ -0,0 +1,126 @@
+/**************************************************************************/
+/*  overhead_budget.cpp                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "overhead_budget.h"
+
+#include <chrono>
+#include <string>
+
+using namespace godot;
+
+static thread_local int scope_depth = 0;
+
+int64_t OverheadBudget::now_nsec() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+OverheadBudget::Scope::Scope(OverheadBudget &r_budget) {
+	// One relaxed load when the budget is off.
+	if (!r_budget.is_enabled()) {
+		return;
+	}
+	entered = true;
+	if (scope_depth++ == 0) {
+		budget = &r_budget;
+		start_nsec = now_nsec();
+	}
+}
+
+OverheadBudget::Scope::~Scope() {
+	if (!entered) {
+		return;
+	}
+	scope_depth--;
+	if (budget) {
+		budget->frame_nsec.fetch_add(now_nsec() - start_nsec, std::memory_order_relaxed);
+	}
+}
+
+void OverheadBudget::configure(double p_budget_usec) {
+	budget_nsec = p_budget_usec > 0.0 ? (int64_t)(p_budget_usec * 1000.0) : 0;
+	average = 0.0;
+	frames_over = 0;
+	frames_under = 0;
+	frame_nsec.store(0, std::memory_order_relaxed);
+	average_nsec.store(0, std::memory_order_relaxed);
+	level.store(LEVEL_NONE, std::memory_order_relaxed);
+	enabled.store(budget_nsec > 0, std::memory_order_relaxed);
+}
+
+bool OverheadBudget::end_frame() {
+	int64_t spent = frame_nsec.exchange(0, std::memory_order_relaxed);
+	if (budget_nsec <= 0) {
+		return false;
+	}
+	average += SMOOTHING * ((double)spent - average);
+	average_nsec.store((int64_t)average, std::memory_order_relaxed);
+
+	if (average > (double)budget_nsec) {
+		frames_over++;
+		frames_under = 0;
+	} else if (average < (double)budget_nsec * RECOVERY_RATIO) {
+		frames_under++;
+		frames_over = 0;
+	} else {
+		frames_over = 0;
+		frames_under = 0;
+	}
+
+	int current = level.load(std::memory_order_relaxed);
+	int next = current;
+	if (frames_over >= STEP_DOWN_FRAMES && current < LEVEL_MAX) {
+		next = current + 1;
+	} else if (frames_under >= STEP_UP_FRAMES && current > LEVEL_NONE) {
+		next = current - 1;
+	}
+	if (next == current) {
+		return false;
+	}
+	// Each step gets the full number of frames to show its effect.
+	frames_over = 0;
+	frames_under = 0;
+	level.store(next, std::memory_order_relaxed);
+	return true;
+}
+
+void OverheadBudget::observe(MetricViewRegistry &r_views, MetricAggregator &r_aggregator, uint64_t p_time_unix_nano) const {
+	if (!is_enabled()) {
+		return;
+	}
+	static const std::string no_attributes = "{}";
+	std::shared_ptr<const MetricStream> stream = r_views.resolve("otel.sdk.overhead.degradation_level", MetricAggregator::METRIC_TYPE_GAUGE);
+	if (!stream->drop) {
+		r_aggregator.record(*stream, "1", no_attributes, (double)get_level(), p_time_unix_nano);
+	}
+	stream = r_views.resolve("otel.sdk.overhead.frame_time", MetricAggregator::METRIC_TYPE_GAUGE);
+	if (!stream->drop) {
+		r_aggregator.record(*stream, "s", no_attributes, (double)get_average_nsec() / 1000000000.0, p_time_unix_nano);
+	}
+}
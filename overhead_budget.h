@@ -0,0 +1,108 @@
+/**************************************************************************/
+/*  overhead_budget.h                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef OVERHEAD_BUDGET_H
+#define OVERHEAD_BUDGET_H
+
+#include <atomic>
+#include <cstdint>
+
+#include "metric_aggregator.h"
+#include "metric_view.h"
+
+namespace godot {
+
+// Keeps the time the SDK spends per frame within a budget by stepping
+// through degradation levels.
+//
+// Work is timed with Scope. Only the outermost Scope of a thread measures,
+// so public methods that call each other are counted once. All threads add
+// to one atomic; end_frame() takes the sum once per frame and smooths it
+// with an exponential moving average, which spreads a periodic flush over
+// the frames around it instead of letting it trip the budget alone. The
+// level rises one step once the average stayed over the budget for
+// STEP_DOWN_FRAMES frames, and falls one step once it stayed under
+// RECOVERY_RATIO of the budget for STEP_UP_FRAMES frames.
+class OverheadBudget {
+public:
+	// Each level includes the ones before it.
+	enum Level {
+		LEVEL_NONE = 0,
+		LEVEL_NO_DEBUG_LOGS = 1, // Log records below INFO are dropped.
+		LEVEL_AGGREGATED_METRICS = 2, // No exemplars and no frame profiler spans.
+		LEVEL_SAMPLED_TRACES = 3, // New traces are sampled down further.
+		LEVEL_MAX = LEVEL_SAMPLED_TRACES,
+	};
+
+	static const int STEP_DOWN_FRAMES = 30;
+	static const int STEP_UP_FRAMES = 300;
+	static constexpr double SMOOTHING = 0.1;
+	static constexpr double RECOVERY_RATIO = 0.5;
+
+	class Scope {
+		OverheadBudget *budget = nullptr; // Set for the outermost scope only.
+		int64_t start_nsec = 0;
+		bool entered = false;
+
+	public:
+		explicit Scope(OverheadBudget &r_budget);
+		~Scope();
+	};
+
+private:
+	std::atomic<bool> enabled{ false };
+	std::atomic<int64_t> frame_nsec{ 0 };
+	std::atomic<int> level{ LEVEL_NONE };
+	std::atomic<int64_t> average_nsec{ 0 };
+	// Only used by configure() and end_frame(), on the main thread.
+	int64_t budget_nsec = 0;
+	double average = 0.0;
+	int frames_over = 0;
+	int frames_under = 0;
+
+	static int64_t now_nsec();
+
+public:
+	// A budget of 0 disables the budget and returns to LEVEL_NONE.
+	void configure(double p_budget_usec);
+	// Accounts the time measured since the last call to the frame that
+	// just ended. Returns whether the level changed.
+	bool end_frame();
+	void observe(MetricViewRegistry &r_views, MetricAggregator &r_aggregator, uint64_t p_time_unix_nano) const;
+
+	bool is_enabled() const { return enabled.load(std::memory_order_relaxed); }
+	int get_level() const { return level.load(std::memory_order_relaxed); }
+	// Smoothed time per frame.
+	int64_t get_average_nsec() const { return average_nsec.load(std::memory_order_relaxed); }
+};
+
+} // namespace godot
+
+#endif // OVERHEAD_BUDGET_H
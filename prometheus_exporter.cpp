@@ -0,0 +1,162 @@
+/**************************************************************************/
+/*  prometheus_exporter.cpp                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "prometheus_exporter.h"
+
+#include "openmetrics_writer.h"
+
+#include <godot_cpp/classes/time.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+
+#include <cstring>
+
+using namespace godot;
+
+std::string PrometheusExporter::build_response(const std::string &p_request, const std::function<std::string()> &p_render) {
+	// Only the request line matters: "GET /metrics HTTP/1.1".
+	size_t line_end = p_request.find("\r\n");
+	std::string request_line = p_request.substr(0, line_end);
+	size_t method_end = request_line.find(' ');
+	size_t path_end = method_end == std::string::npos ? std::string::npos : request_line.find(' ', method_end + 1);
+	std::string method = request_line.substr(0, method_end);
+	std::string path = method_end == std::string::npos ? std::string() : request_line.substr(method_end + 1, path_end - method_end - 1);
+	size_t query = path.find('?');
+	if (query != std::string::npos) {
+		path.resize(query);
+	}
+
+	std::string status;
+	std::string content_type;
+	std::string body;
+	if (method != "GET") {
+		status = "405 Method Not Allowed";
+		content_type = "text/plain; charset=utf-8";
+		body = "Method Not Allowed\n";
+	} else if (path != "/metrics" && path != "/") {
+		status = "404 Not Found";
+		content_type = "text/plain; charset=utf-8";
+		body = "Not Found\n";
+	} else {
+		status = "200 OK";
+		content_type = OpenMetricsWriter::CONTENT_TYPE;
+		body = p_render();
+	}
+
+	std::string response = "HTTP/1.1 " + status + "\r\n";
+	response += "Content-Type: " + content_type + "\r\n";
+	response += "Content-Length: " + std::to_string(body.size()) + "\r\n";
+	response += "Connection: close\r\n\r\n";
+	response += body;
+	return response;
+}
+
+Error PrometheusExporter::start(int p_port, const String &p_bind_address) {
+	stop();
+	server.instantiate();
+	Error err = server->listen(p_port, p_bind_address);
+	if (err != OK) {
+		server.unref();
+	}
+	return err;
+}
+
+void PrometheusExporter::stop() {
+	for (Client &client : clients) {
+		client.peer->disconnect_from_host();
+	}
+	clients.clear();
+	if (server.is_valid()) {
+		server->stop();
+		server.unref();
+	}
+}
+
+bool PrometheusExporter::is_listening() const {
+	return server.is_valid() && server->is_listening();
+}
+
+void PrometheusExporter::poll(const std::function<std::string()> &p_render) {
+	if (!is_listening()) {
+		return;
+	}
+
+	uint64_t now = Time::get_singleton()->get_ticks_msec();
+	while (server->is_connection_available()) {
+		Client client;
+		client.peer = server->take_connection();
+		client.connected_msec = now;
+		if (client.peer.is_valid()) {
+			clients.push_back(std::move(client));
+		}
+	}
+
+	for (size_t i = 0; i < clients.size();) {
+		Client &client = clients[i];
+		client.peer->poll();
+		bool done = client.peer->get_status() != StreamPeerTCP::STATUS_CONNECTED || now - client.connected_msec > CLIENT_TIMEOUT_MSEC;
+
+		if (!done && client.response.empty()) {
+			int32_t available = client.peer->get_available_bytes();
+			if (available > 0) {
+				Array result = client.peer->get_partial_data(available);
+				if ((int)result[0] == OK) {
+					PackedByteArray data = result[1];
+					client.request.append((const char *)data.ptr(), data.size());
+				}
+			}
+			if (client.request.find("\r\n\r\n") != std::string::npos || client.request.size() > MAX_REQUEST_SIZE) {
+				client.response = build_response(client.request, p_render);
+			}
+		}
+
+		if (!done && !client.response.empty()) {
+			// Write what the socket accepts now and continue on the next poll.
+			PackedByteArray chunk;
+			chunk.resize(client.response.size() - client.sent);
+			memcpy(chunk.ptrw(), client.response.data() + client.sent, chunk.size());
+			Array result = client.peer->put_partial_data(chunk);
+			if ((int)result[0] == OK) {
+				client.sent += (int)result[1];
+			} else {
+				done = true;
+			}
+			if (client.sent >= client.response.size()) {
+				done = true;
+			}
+		}
+
+		if (done) {
+			client.peer->disconnect_from_host();
+			clients.erase(clients.begin() + i);
+		} else {
+			i++;
+		}
+	}
+}
@@ -0,0 +1,73 @@
+/**************************************************************************/
+/*  prometheus_exporter.h                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef PROMETHEUS_EXPORTER_H
+#define PROMETHEUS_EXPORTER_H
+
+#include <godot_cpp/classes/stream_peer_tcp.hpp>
+#include <godot_cpp/classes/tcp_server.hpp>
+#include <godot_cpp/variant/string.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace godot {
+
+// Minimal non-blocking HTTP server answering Prometheus scrapes on a local
+// port. It is driven by poll() from the main loop and never blocks it.
+class PrometheusExporter {
+	struct Client {
+		Ref<StreamPeerTCP> peer;
+		std::string request;
+		std::string response;
+		size_t sent = 0;
+		uint64_t connected_msec = 0;
+	};
+
+	static const size_t MAX_REQUEST_SIZE = 8192;
+	static const uint64_t CLIENT_TIMEOUT_MSEC = 5000;
+
+	Ref<TCPServer> server;
+	std::vector<Client> clients;
+
+	static std::string build_response(const std::string &p_request, const std::function<std::string()> &p_render);
+
+public:
+	Error start(int p_port, const String &p_bind_address);
+	void stop();
+	bool is_listening() const;
+	void poll(const std::function<std::string()> &p_render);
+};
+
+} // namespace godot
+
+#endif // PROMETHEUS_EXPORTER_H
@@ -34,7 +34,10 @@
 #include <godot_cpp/core/defs.hpp>
 #include <godot_cpp/godot.hpp>
 
+#include "engine_logger.h"
+#include "frame_profiler.h"
 #include "open_telemetry.h"
+#include "span_scope.h"
 
 using namespace godot;
 
@@ -43,6 +46,9 @@ void initialize_opentelemetry_module(ModuleInitializationLevel p_level) {
 		return;
 	}
 	ClassDB::register_class<OpenTelemetry>();
+	ClassDB::register_class<OpenTelemetryProfiler>();
+	ClassDB::register_class<OpenTelemetryLogger>();
+	ClassDB::register_class<OpenTelemetryScope>();
 }
 
 void uninitialize_opentelemetry_module(ModuleInitializationLevel p_level) {
@@ -0,0 +1,300 @@
+/**************************************************************************/
+/*  sampler.cpp                                                           */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "sampler.h"
+
+#include "trace_state.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+using namespace godot;
+
+static const int HEX_DIGITS = 14;
+
+static bool parse_hex(const std::string &p_string, size_t p_start, size_t p_end, uint64_t &r_value) {
+	uint64_t value = 0;
+	for (size_t i = p_start; i < p_end; i++) {
+		char c = p_string[i];
+		uint64_t digit;
+		if (c >= '0' && c <= '9') {
+			digit = c - '0';
+		} else if (c >= 'a' && c <= 'f') {
+			digit = c - 'a' + 10;
+		} else if (c >= 'A' && c <= 'F') {
+			digit = c - 'A' + 10;
+		} else {
+			return false;
+		}
+		value = (value << 4) | digit;
+	}
+	r_value = value;
+	return true;
+}
+
+uint64_t ConsistentProbability::threshold_for_probability(double p_probability, int p_precision) {
+	if (p_probability >= 1.0) {
+		return 0;
+	}
+	if (p_probability <= 0.0) {
+		return MAX_ADJUSTED_COUNT;
+	}
+	// Extra digits for probabilities near 0 or 1, where the leading digits
+	// of the threshold are all 0 or f.
+	int exponent_probability = 0;
+	int exponent_rejection = 0;
+	std::frexp(p_probability, &exponent_probability);
+	std::frexp(1.0 - p_probability, &exponent_rejection);
+	int precision = std::min(HEX_DIGITS, std::max(p_precision + exponent_probability / -4, p_precision + exponent_rejection / -4));
+
+	uint64_t scaled = (uint64_t)std::llround(p_probability * (double)MAX_ADJUSTED_COUNT);
+	uint64_t threshold = MAX_ADJUSTED_COUNT - std::min(scaled, MAX_ADJUSTED_COUNT);
+	int shift = 4 * (HEX_DIGITS - precision);
+	if (shift > 0) {
+		threshold += 1ULL << (shift - 1);
+		threshold >>= shift;
+		threshold <<= shift;
+	}
+	return std::min(threshold, MAX_ADJUSTED_COUNT - 1);
+}
+
+std::string ConsistentProbability::encode_threshold(uint64_t p_threshold) {
+	if (p_threshold == 0) {
+		return "0";
+	}
+	char buffer[17];
+	snprintf(buffer, sizeof(buffer), "%014llx", (unsigned long long)(p_threshold & (MAX_ADJUSTED_COUNT - 1)));
+	std::string encoded = buffer;
+	encoded.erase(encoded.find_last_not_of('0') + 1);
+	return encoded;
+}
+
+bool ConsistentProbability::decode_threshold(const std::string &p_value, uint64_t &r_threshold) {
+	if (p_value.empty() || p_value.size() > HEX_DIGITS) {
+		return false;
+	}
+	uint64_t value = 0;
+	if (!parse_hex(p_value, 0, p_value.size(), value)) {
+		return false;
+	}
+	// Missing trailing digits are zeros.
+	r_threshold = value << (4 * (HEX_DIGITS - p_value.size()));
+	return true;
+}
+
+uint64_t ConsistentProbability::get_randomness(const std::string &p_trace_id, const std::string &p_trace_state) {
+	std::string rv;
+	uint64_t randomness = 0;
+	if (!p_trace_state.empty() && TraceState::get_ot_value(p_trace_state, "rv", rv) && rv.size() == HEX_DIGITS && parse_hex(rv, 0, rv.size(), randomness)) {
+		return randomness;
+	}
+	size_t start = p_trace_id.size() > HEX_DIGITS ? p_trace_id.size() - HEX_DIGITS : 0;
+	if (!parse_hex(p_trace_id, start, p_trace_id.size(), randomness)) {
+		return 0;
+	}
+	return randomness & (MAX_ADJUSTED_COUNT - 1);
+}
+
+double ConsistentProbability::adjusted_count(uint64_t p_threshold) {
+	if (p_threshold >= MAX_ADJUSTED_COUNT) {
+		return 0.0;
+	}
+	return (double)MAX_ADJUSTED_COUNT / (double)(MAX_ADJUSTED_COUNT - p_threshold);
+}
+
+double ConsistentProbability::adjusted_count_for_trace_state(const std::string &p_trace_state) {
+	std::string th;
+	uint64_t threshold = 0;
+	if (!TraceState::get_ot_value(p_trace_state, "th", th) || !decode_threshold(th, threshold)) {
+		return 0.0;
+	}
+	return adjusted_count(threshold);
+}
+
+Sampler::Result AlwaysOnSampler::should_sample(const SpanContext *p_parent, const std::string &p_trace_id, const char *p_name) {
+	Result result;
+	result.decision = DECISION_RECORD_AND_SAMPLE;
+	if (p_parent) {
+		result.trace_state = p_parent->trace_state;
+	}
+	return result;
+}
+
+Sampler::Result AlwaysOffSampler::should_sample(const SpanContext *p_parent, const std::string &p_trace_id, const char *p_name) {
+	Result result;
+	if (p_parent) {
+		result.trace_state = p_parent->trace_state;
+	}
+	return result;
+}
+
+Sampler::Result TraceIdRatioBasedSampler::should_sample(const SpanContext *p_parent, const std::string &p_trace_id, const char *p_name) {
+	Result result;
+	const std::string empty;
+	const std::string &trace_state = p_parent ? p_parent->trace_state : empty;
+	if (ConsistentProbability::get_randomness(p_trace_id, trace_state) >= threshold) {
+		result.decision = DECISION_RECORD_AND_SAMPLE;
+		result.trace_state = TraceState::set_ot_value(trace_state, "th", encoded_threshold);
+	} else {
+		result.trace_state = trace_state;
+	}
+	return result;
+}
+
+TraceIdRatioBasedSampler::TraceIdRatioBasedSampler(double p_ratio) {
+	threshold = ConsistentProbability::threshold_for_probability(p_ratio);
+	encoded_threshold = ConsistentProbability::encode_threshold(threshold);
+}
+
+Sampler::Result ParentBasedSampler::should_sample(const SpanContext *p_parent, const std::string &p_trace_id, const char *p_name) {
+	if (!p_parent) {
+		return root->should_sample(p_parent, p_trace_id, p_name);
+	}
+
+	Sampler *delegate;
+	if (p_parent->is_remote) {
+		delegate = p_parent->sampled ? remote_parent_sampled.get() : remote_parent_not_sampled.get();
+	} else {
+		delegate = p_parent->sampled ? local_parent_sampled.get() : local_parent_not_sampled.get();
+	}
+	Result result = delegate->should_sample(p_parent, p_trace_id, p_name);
+
+	// A sampled parent whose threshold exceeds the randomness was not
+	// sampled consistently, so its threshold no longer means anything.
+	std::string th;
+	uint64_t threshold = 0;
+	if (result.decision == DECISION_RECORD_AND_SAMPLE && TraceState::get_ot_value(result.trace_state, "th", th)) {
+		if (!ConsistentProbability::decode_threshold(th, threshold) ||
+				ConsistentProbability::get_randomness(p_trace_id, result.trace_state) < threshold) {
+			result.trace_state = TraceState::set_ot_value(result.trace_state, "th", std::string());
+		}
+	}
+	return result;
+}
+
+ParentBasedSampler::ParentBasedSampler(std::shared_ptr<Sampler> p_root) :
+		root(std::move(p_root)),
+		remote_parent_sampled(std::make_shared<AlwaysOnSampler>()),
+		remote_parent_not_sampled(std::make_shared<AlwaysOffSampler>()),
+		local_parent_sampled(remote_parent_sampled),
+		local_parent_not_sampled(remote_parent_not_sampled) {
+}
+
+uint64_t SpanRateLimiter::hash_name(const char *p_name) {
+	// FNV-1a; 0 marks an empty slot, so it is never returned.
+	uint64_t hash = 0xcbf29ce484222325ULL;
+	for (const char *c = p_name; *c; c++) {
+		hash ^= (uint8_t)*c;
+		hash *= 0x100000001b3ULL;
+	}
+	return hash | 1;
+}
+
+SpanRateLimiter::Slot &SpanRateLimiter::get_slot(const char *p_name) {
+	uint64_t key = hash_name(p_name);
+	for (int probe = 0; probe < MAX_PROBES; probe++) {
+		Slot &slot = slots[(key + probe) & (SLOT_COUNT - 1)];
+		uint64_t current = slot.key.load(std::memory_order_acquire);
+		if (current == key) {
+			return slot;
+		}
+		if (current == 0) {
+			if (slot.key.compare_exchange_strong(current, key, std::memory_order_acq_rel)) {
+				// The name is only read for reporting, after `ready` is set.
+				strncpy(slot.name, p_name, MAX_NAME_LENGTH - 1);
+				slot.ready.store(true, std::memory_order_release);
+				return slot;
+			}
+			if (current == key) {
+				return slot;
+			}
+		}
+	}
+	return overflow;
+}
+
+bool SpanRateLimiter::try_acquire(const char *p_name, int64_t p_now_nsec) {
+	Slot &slot = get_slot(p_name ? p_name : "");
+	int64_t arrival = slot.theoretical_arrival.load(std::memory_order_relaxed);
+	while (true) {
+		if (arrival - p_now_nsec > burst_tolerance_nsec) {
+			slot.dropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		int64_t next = std::max(arrival, p_now_nsec) + emission_interval_nsec;
+		if (slot.theoretical_arrival.compare_exchange_weak(arrival, next, std::memory_order_relaxed)) {
+			return true;
+		}
+	}
+}
+
+void SpanRateLimiter::collect_dropped(std::vector<std::pair<std::string, uint64_t>> &r_dropped) {
+	for (Slot &slot : slots) {
+		if (!slot.ready.load(std::memory_order_acquire)) {
+			continue;
+		}
+		uint64_t dropped = slot.dropped.exchange(0, std::memory_order_relaxed);
+		if (dropped > 0) {
+			r_dropped.emplace_back(std::string(slot.name), dropped);
+		}
+	}
+	uint64_t dropped = overflow.dropped.exchange(0, std::memory_order_relaxed);
+	if (dropped > 0) {
+		r_dropped.emplace_back(std::string(), dropped);
+	}
+}
+
+SpanRateLimiter::SpanRateLimiter(double p_spans_per_second, int p_burst) {
+	double rate = std::max(p_spans_per_second, 0.001);
+	emission_interval_nsec = std::max((int64_t)(1e9 / rate), (int64_t)1);
+	// A full bucket admits `burst` spans at once: the first at `now`, the
+	// rest within the tolerance.
+	burst_tolerance_nsec = emission_interval_nsec * (int64_t)(std::clamp(p_burst, 1, 1000000) - 1);
+}
+
+Sampler::Result RateLimitingSampler::should_sample(const SpanContext *p_parent, const std::string &p_trace_id, const char *p_name) {
+	Result result = delegate->should_sample(p_parent, p_trace_id, p_name);
+	if (result.decision == DECISION_DROP) {
+		return result;
+	}
+	int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	if (!limiter->try_acquire(p_name, now)) {
+		Result dropped;
+		dropped.rate_limited = true;
+		return dropped;
+	}
+	return result;
+}
+
+RateLimitingSampler::RateLimitingSampler(std::shared_ptr<Sampler> p_delegate, std::shared_ptr<SpanRateLimiter> p_limiter) :
+		delegate(std::move(p_delegate)), limiter(std::move(p_limiter)) {
+}
@@ -0,0 +1,180 @@
+/**************************************************************************/
+/*  sampler.h                                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "span_context.h"
+
+namespace godot {
+
+// Consistent probability sampling from the OpenTelemetry tracestate
+// probability sampling specification. A span is kept when its 56-bit
+// randomness R is at least the rejection threshold T; T travels in the
+// tracestate as `ot=th:<hex>` so every participant can derive the
+// probability and adjusted count of what it received.
+class ConsistentProbability {
+public:
+	static constexpr uint64_t MAX_ADJUSTED_COUNT = 1ULL << 56;
+	static const int DEFAULT_PRECISION = 4;
+
+	static uint64_t threshold_for_probability(double p_probability, int p_precision = DEFAULT_PRECISION);
+	static std::string encode_threshold(uint64_t p_threshold);
+	static bool decode_threshold(const std::string &p_value, uint64_t &r_threshold);
+	// Explicit `rv` randomness when present, else the low 56 bits of the id.
+	static uint64_t get_randomness(const std::string &p_trace_id, const std::string &p_trace_state);
+	static double adjusted_count(uint64_t p_threshold);
+	// 0 when the tracestate carries no threshold, i.e. the count is unknown.
+	static double adjusted_count_for_trace_state(const std::string &p_trace_state);
+};
+
+// Head sampling as described in the tracing SDK specification. A sampler is
+// consulted before a span is created; spans it drops are never stored,
+// formatted or exported.
+class Sampler {
+public:
+	enum Decision {
+		DECISION_DROP = 0,
+		DECISION_RECORD_AND_SAMPLE = 2,
+	};
+
+	struct Result {
+		Decision decision = DECISION_DROP;
+		std::string trace_state; // Tracestate of the new span.
+		bool rate_limited = false; // Dropped by a RateLimitingSampler.
+	};
+
+	// `p_parent` is null for root spans. `p_trace_id` is the hex trace id
+	// the new span will belong to.
+	virtual Result should_sample(const SpanContext *p_parent, const std::string &p_trace_id, const char *p_name) = 0;
+	virtual ~Sampler() {}
+};
+
+class AlwaysOnSampler : public Sampler {
+public:
+	Result should_sample(const SpanContext *p_parent, const std::string &p_trace_id, const char *p_name) override;
+};
+
+class AlwaysOffSampler : public Sampler {
+public:
+	Result should_sample(const SpanContext *p_parent, const std::string &p_trace_id, const char *p_name) override;
+};
+
+// Consistent probability sampler: one 56-bit compare of the trace
+// randomness against the threshold derived from `ratio`. Sampled spans
+// carry the threshold in their tracestate.
+class TraceIdRatioBasedSampler : public Sampler {
+	uint64_t threshold = 0;
+	std::string encoded_threshold;
+
+public:
+	Result should_sample(const SpanContext *p_parent, const std::string &p_trace_id, const char *p_name) override;
+
+	explicit TraceIdRatioBasedSampler(double p_ratio);
+};
+
+// Follows the parent's sampled flag and delegates root spans to `root`.
+// The parent's threshold is propagated, or erased when it is inconsistent
+// with the trace randomness.
+class ParentBasedSampler : public Sampler {
+	std::shared_ptr<Sampler> root;
+	std::shared_ptr<Sampler> remote_parent_sampled;
+	std::shared_ptr<Sampler> remote_parent_not_sampled;
+	std::shared_ptr<Sampler> local_parent_sampled;
+	std::shared_ptr<Sampler> local_parent_not_sampled;
+
+public:
+	Result should_sample(const SpanContext *p_parent, const std::string &p_trace_id, const char *p_name) override;
+
+	explicit ParentBasedSampler(std::shared_ptr<Sampler> p_root);
+};
+
+// Per-span-name token buckets that cap how many spans of one name are
+// recorded per second. Each bucket is a single atomic "theoretical arrival
+// time" (GCRA), so acquiring a token is one compare-and-swap and never
+// takes a lock. Buckets live in a fixed open-addressing table; names that
+// do not fit share one overflow bucket. Refused spans are counted per name
+// and drained by collect_dropped().
+class SpanRateLimiter {
+public:
+	static const int SLOT_COUNT = 512;
+	static const int MAX_PROBES = 16;
+	static const int MAX_NAME_LENGTH = 64;
+
+private:
+	struct Slot {
+		std::atomic<uint64_t> key{ 0 };
+		std::atomic<bool> ready{ false };
+		char name[MAX_NAME_LENGTH] = {};
+		std::atomic<int64_t> theoretical_arrival{ 0 };
+		std::atomic<uint64_t> dropped{ 0 };
+	};
+
+	int64_t emission_interval_nsec = 0;
+	int64_t burst_tolerance_nsec = 0;
+	Slot slots[SLOT_COUNT];
+	Slot overflow;
+
+	static uint64_t hash_name(const char *p_name);
+	Slot &get_slot(const char *p_name);
+
+public:
+	// Returns false, and counts the span as dropped, when the bucket for
+	// `p_name` is empty at `p_now_nsec`.
+	bool try_acquire(const char *p_name, int64_t p_now_nsec);
+	// Appends (name, count) for every bucket that dropped spans since the
+	// last call and resets those counts. The overflow bucket has an empty
+	// name.
+	void collect_dropped(std::vector<std::pair<std::string, uint64_t>> &r_dropped);
+
+	SpanRateLimiter(double p_spans_per_second, int p_burst);
+};
+
+// Applies a SpanRateLimiter to the spans `delegate` decided to sample.
+class RateLimitingSampler : public Sampler {
+	std::shared_ptr<Sampler> delegate;
+	std::shared_ptr<SpanRateLimiter> limiter;
+
+public:
+	Result should_sample(const SpanContext *p_parent, const std::string &p_trace_id, const char *p_name) override;
+
+	RateLimitingSampler(std::shared_ptr<Sampler> p_delegate, std::shared_ptr<SpanRateLimiter> p_limiter);
+};
+
+} // namespace godot
+
+#endif // SAMPLER_H
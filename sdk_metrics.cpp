@@ -0,0 +1,176 @@
+/**************************************************************************/
+/*  sdk_metrics.cpp                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "sdk_metrics.h"
+
+#include <algorithm>
+#include <string>
+
+using namespace godot;
+
+namespace {
+
+struct SignalInfo {
+	const char *key; // Key of the signal in snapshot().
+	const char *unit;
+	const char *queue_metric; // Null when the signal has no buffer.
+	const char *exported_metric;
+	const char *dropped_metric;
+	const char *exporter_attributes;
+};
+
+// Names follow the SDK self-observability semantic conventions where they
+// define one.
+const SignalInfo signal_info[OtlpHttpExporter::SIGNAL_MAX] = {
+	{ "spans", "{span}", "otel.sdk.processor.span.queue.size", "otel.sdk.exporter.span.exported", "otel.sdk.span.dropped",
+			"{\"otel.component.type\":\"otlp_http_json_span_exporter\"}" },
+	{ "metrics", "{data_point}", nullptr, "otel.sdk.exporter.metric_data_point.exported", "otel.sdk.metric_data_point.dropped",
+			"{\"otel.component.type\":\"otlp_http_json_metric_exporter\"}" },
+	{ "logs", "{log_record}", "otel.sdk.processor.log.queue.size", "otel.sdk.exporter.log.exported", "otel.sdk.log.dropped",
+			"{\"otel.component.type\":\"otlp_http_json_log_exporter\"}" },
+};
+
+const char *drop_reasons[SdkMetrics::DROP_REASON_MAX] = {
+	"sampler",
+	"rate_limit",
+	"severity",
+	"deduplicated",
+	"queue_full",
+	"export_failed",
+	"rejected",
+	"overhead_budget",
+};
+
+void record_metric(MetricViewRegistry &r_views, MetricAggregator &r_aggregator, const char *p_name, int p_type, const char *p_unit, const std::string &p_attributes, double p_value, uint64_t p_time_unix_nano) {
+	// Views apply to the SDK's own instruments like to any other.
+	std::shared_ptr<const MetricStream> stream = r_views.resolve(p_name, p_type);
+	if (stream->drop) {
+		return;
+	}
+	r_aggregator.record(*stream, p_unit, p_attributes, p_value, p_time_unix_nano);
+}
+
+// Records the growth of a cumulative counter since the last observation.
+void record_delta(MetricViewRegistry &r_views, MetricAggregator &r_aggregator, const char *p_name, const char *p_unit, const std::string &p_attributes, uint64_t p_value, uint64_t &r_observed, uint64_t p_time_unix_nano) {
+	if (p_value == r_observed) {
+		return;
+	}
+	uint64_t delta = p_value - r_observed;
+	r_observed = p_value;
+	record_metric(r_views, r_aggregator, p_name, MetricAggregator::METRIC_TYPE_COUNTER, p_unit, p_attributes, (double)delta, p_time_unix_nano);
+}
+
+} // namespace
+
+const char *SdkMetrics::EXPORT_DURATION_METRIC = "otel.sdk.exporter.operation.duration";
+
+void SdkMetrics::record_export(OtlpHttpExporter::Signal p_signal, const OtlpHttpExporter::Response &p_response, uint64_t p_items, uint64_t p_duration_usec, bool p_retried) {
+	SignalCounters &counters = signals[p_signal];
+	counters.exports.fetch_add(1, std::memory_order_relaxed);
+	counters.export_duration_usec.fetch_add(p_duration_usec, std::memory_order_relaxed);
+	counters.last_export_duration_usec.store(p_duration_usec, std::memory_order_relaxed);
+	counters.request_bytes.fetch_add(p_response.request_bytes, std::memory_order_relaxed);
+	if (p_retried) {
+		counters.retries.fetch_add(1, std::memory_order_relaxed);
+	} else if (!p_response.is_success()) {
+		counters.dropped[DROP_EXPORT_FAILED].fetch_add(p_items, std::memory_order_relaxed);
+	} else {
+		uint64_t rejected = std::min((uint64_t)std::max(p_response.rejected, (int64_t)0), p_items);
+		counters.dropped[DROP_REJECTED].fetch_add(rejected, std::memory_order_relaxed);
+		counters.exported.fetch_add(p_items - rejected, std::memory_order_relaxed);
+	}
+}
+
+const std::string &SdkMetrics::get_exporter_attributes(OtlpHttpExporter::Signal p_signal) {
+	static const std::string attributes[OtlpHttpExporter::SIGNAL_MAX] = {
+		signal_info[OtlpHttpExporter::SIGNAL_TRACES].exporter_attributes,
+		signal_info[OtlpHttpExporter::SIGNAL_METRICS].exporter_attributes,
+		signal_info[OtlpHttpExporter::SIGNAL_LOGS].exporter_attributes,
+	};
+	return attributes[p_signal];
+}
+
+void SdkMetrics::observe(MetricViewRegistry &r_views, MetricAggregator &r_aggregator, uint64_t p_time_unix_nano) {
+	std::lock_guard<std::mutex> lock(observe_mutex);
+	static const std::string no_attributes = "{}";
+
+	record_metric(r_views, r_aggregator, "otel.sdk.span.live", MetricAggregator::METRIC_TYPE_GAUGE, "{span}", no_attributes,
+			(double)live_spans.load(std::memory_order_relaxed), p_time_unix_nano);
+	record_metric(r_views, r_aggregator, "otel.sdk.buffer.memory.usage", MetricAggregator::METRIC_TYPE_GAUGE, "By", no_attributes,
+			(double)buffer_memory_bytes.load(std::memory_order_relaxed), p_time_unix_nano);
+
+	for (int i = 0; i < OtlpHttpExporter::SIGNAL_MAX; i++) {
+		const SignalInfo &info = signal_info[i];
+		const SignalCounters &counters = signals[i];
+		ObservedCounters &last = observed[i];
+		const std::string &exporter_attributes = get_exporter_attributes((OtlpHttpExporter::Signal)i);
+
+		if (info.queue_metric) {
+			record_metric(r_views, r_aggregator, info.queue_metric, MetricAggregator::METRIC_TYPE_GAUGE, info.unit, no_attributes,
+					(double)counters.pending.load(std::memory_order_relaxed), p_time_unix_nano);
+		}
+		record_delta(r_views, r_aggregator, info.exported_metric, info.unit, exporter_attributes,
+				counters.exported.load(std::memory_order_relaxed), last.exported, p_time_unix_nano);
+		for (int reason = 0; reason < DROP_REASON_MAX; reason++) {
+			std::string attributes = std::string("{\"reason\":\"") + drop_reasons[reason] + "\"}";
+			record_delta(r_views, r_aggregator, info.dropped_metric, info.unit, attributes,
+					counters.dropped[reason].load(std::memory_order_relaxed), last.dropped[reason], p_time_unix_nano);
+		}
+		record_delta(r_views, r_aggregator, "otel.sdk.exporter.request.size", "By", exporter_attributes,
+				counters.request_bytes.load(std::memory_order_relaxed), last.request_bytes, p_time_unix_nano);
+		record_delta(r_views, r_aggregator, "otel.sdk.exporter.retries", "{request}", exporter_attributes,
+				counters.retries.load(std::memory_order_relaxed), last.retries, p_time_unix_nano);
+	}
+}
+
+Dictionary SdkMetrics::snapshot(uint64_t p_metric_series) const {
+	Dictionary stats;
+	for (int i = 0; i < OtlpHttpExporter::SIGNAL_MAX; i++) {
+		const SignalCounters &counters = signals[i];
+		Dictionary signal;
+		signal["pending"] = i == OtlpHttpExporter::SIGNAL_METRICS ? p_metric_series : counters.pending.load(std::memory_order_relaxed);
+		signal["exported"] = counters.exported.load(std::memory_order_relaxed);
+		Dictionary dropped;
+		for (int reason = 0; reason < DROP_REASON_MAX; reason++) {
+			dropped[drop_reasons[reason]] = counters.dropped[reason].load(std::memory_order_relaxed);
+		}
+		signal["dropped"] = dropped;
+		signal["exports"] = counters.exports.load(std::memory_order_relaxed);
+		signal["export_duration_usec"] = counters.export_duration_usec.load(std::memory_order_relaxed);
+		signal["last_export_duration_usec"] = counters.last_export_duration_usec.load(std::memory_order_relaxed);
+		signal["request_bytes"] = counters.request_bytes.load(std::memory_order_relaxed);
+		signal["retries"] = counters.retries.load(std::memory_order_relaxed);
+		stats[signal_info[i].key] = signal;
+	}
+	Dictionary spans = stats["spans"];
+	spans["live"] = live_spans.load(std::memory_order_relaxed);
+	stats["buffer_memory_bytes"] = buffer_memory_bytes.load(std::memory_order_relaxed);
+	return stats;
+}
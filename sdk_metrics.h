@@ -0,0 +1,122 @@
+/**************************************************************************/
+/*  sdk_metrics.h                                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef SDK_METRICS_H
+#define SDK_METRICS_H
+
+#include <godot_cpp/variant/dictionary.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+#include "metric_aggregator.h"
+#include "metric_view.h"
+#include "otlp_http_exporter.h"
+
+namespace godot {
+
+// Counters the SDK keeps about its own pipeline. Every counter is an atomic
+// updated with relaxed ordering, so recording never takes a lock and
+// snapshot() can be called from any thread while spans and logs are being
+// written. observe() turns them into `otel.sdk.*` instruments once per
+// collection, like EngineMetrics does for the engine monitors.
+class SdkMetrics {
+public:
+	enum DropReason {
+		DROP_SAMPLER, // Not sampled by the head sampler.
+		DROP_RATE_LIMIT, // Refused by the span rate limit.
+		DROP_SEVERITY, // Below the minimum log severity.
+		DROP_DEDUPLICATED, // Collapsed into a deduplication summary.
+		DROP_QUEUE_FULL, // Engine log capture or export queue was full.
+		DROP_EXPORT_FAILED, // Export failed and was not retried again.
+		DROP_REJECTED, // Rejected by the collector in a partial success.
+		DROP_OVERHEAD_BUDGET, // Shed while over the overhead budget.
+		DROP_REASON_MAX,
+	};
+
+private:
+	struct SignalCounters {
+		std::atomic<uint64_t> pending{ 0 };
+		std::atomic<uint64_t> exported{ 0 };
+		std::atomic<uint64_t> dropped[DROP_REASON_MAX] = {};
+		std::atomic<uint64_t> exports{ 0 };
+		std::atomic<uint64_t> export_duration_usec{ 0 };
+		std::atomic<uint64_t> last_export_duration_usec{ 0 };
+		std::atomic<uint64_t> request_bytes{ 0 };
+		std::atomic<uint64_t> retries{ 0 };
+	};
+
+	// Counter values already recorded by observe(), which records deltas.
+	struct ObservedCounters {
+		uint64_t exported = 0;
+		uint64_t dropped[DROP_REASON_MAX] = {};
+		uint64_t request_bytes = 0;
+		uint64_t retries = 0;
+	};
+
+	SignalCounters signals[OtlpHttpExporter::SIGNAL_MAX];
+	std::atomic<int64_t> live_spans{ 0 };
+	std::atomic<uint64_t> buffer_memory_bytes{ 0 };
+	std::mutex observe_mutex;
+	ObservedCounters observed[OtlpHttpExporter::SIGNAL_MAX];
+
+public:
+	static const char *EXPORT_DURATION_METRIC;
+
+	void add_dropped(OtlpHttpExporter::Signal p_signal, DropReason p_reason, uint64_t p_count = 1) {
+		signals[p_signal].dropped[p_reason].fetch_add(p_count, std::memory_order_relaxed);
+	}
+	void add_pending(OtlpHttpExporter::Signal p_signal, uint64_t p_count = 1) {
+		signals[p_signal].pending.fetch_add(p_count, std::memory_order_relaxed);
+	}
+	void set_pending(OtlpHttpExporter::Signal p_signal, uint64_t p_count) {
+		signals[p_signal].pending.store(p_count, std::memory_order_relaxed);
+	}
+	void add_live_span(int64_t p_delta) { live_spans.fetch_add(p_delta, std::memory_order_relaxed); }
+	void set_live_spans(int64_t p_count) { live_spans.store(p_count, std::memory_order_relaxed); }
+	void set_buffer_memory(uint64_t p_bytes) { buffer_memory_bytes.store(p_bytes, std::memory_order_relaxed); }
+
+	// Accounts for one export request of `p_items` items. `p_retried` is
+	// whether the batch stays buffered for another attempt.
+	void record_export(OtlpHttpExporter::Signal p_signal, const OtlpHttpExporter::Response &p_response, uint64_t p_items, uint64_t p_duration_usec, bool p_retried);
+
+	// Attributes identifying the exporter of `p_signal`.
+	static const std::string &get_exporter_attributes(OtlpHttpExporter::Signal p_signal);
+
+	void observe(MetricViewRegistry &r_views, MetricAggregator &r_aggregator, uint64_t p_time_unix_nano);
+	// `p_metric_series` is reported as the pending metrics, since series
+	// are what the aggregator holds until the next collection.
+	Dictionary snapshot(uint64_t p_metric_series) const;
+};
+
+} // namespace godot
+
+#endif // SDK_METRICS_H
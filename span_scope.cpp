@@ -0,0 +1,104 @@
+/**************************************************************************/
+/*  span_scope.cpp                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "span_scope.h"
+
+#include <vector>
+
+using namespace godot;
+
+struct ActiveSpan {
+	String span_uuid;
+	SpanContext context;
+};
+
+static thread_local std::vector<ActiveSpan> active_span_stack;
+
+void ActiveSpanStack::push(const String &p_span_uuid, const SpanContext &p_context) {
+	if (active_span_stack.size() >= MAX_DEPTH) {
+		// Activations that were never deactivated; drop the oldest.
+		active_span_stack.erase(active_span_stack.begin());
+	}
+	active_span_stack.push_back({ p_span_uuid, p_context });
+}
+
+void ActiveSpanStack::pop() {
+	if (!active_span_stack.empty()) {
+		active_span_stack.pop_back();
+	}
+}
+
+void ActiveSpanStack::remove(const String &p_span_uuid) {
+	for (size_t i = active_span_stack.size(); i > 0; i--) {
+		if (active_span_stack[i - 1].span_uuid == p_span_uuid) {
+			active_span_stack.erase(active_span_stack.begin() + (i - 1));
+			return;
+		}
+	}
+}
+
+const String &ActiveSpanStack::get_current() {
+	static const String none;
+	return active_span_stack.empty() ? none : active_span_stack.back().span_uuid;
+}
+
+const SpanContext *ActiveSpanStack::get_current_context() {
+	if (active_span_stack.empty() || !active_span_stack.back().context.is_valid()) {
+		return nullptr;
+	}
+	return &active_span_stack.back().context;
+}
+
+void OpenTelemetryScope::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("close"), &OpenTelemetryScope::close);
+	ClassDB::bind_method(D_METHOD("get_span"), &OpenTelemetryScope::get_span);
+}
+
+void OpenTelemetryScope::open_scope(const String &p_span_uuid, const SpanContext &p_context) {
+	close();
+	span_uuid = p_span_uuid;
+	open = true;
+	ActiveSpanStack::push(span_uuid, p_context);
+}
+
+void OpenTelemetryScope::close() {
+	if (open) {
+		open = false;
+		ActiveSpanStack::remove(span_uuid);
+	}
+}
+
+String OpenTelemetryScope::get_span() const {
+	return span_uuid;
+}
+
+OpenTelemetryScope::~OpenTelemetryScope() {
+	close();
+}
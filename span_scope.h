@@ -0,0 +1,83 @@
+/**************************************************************************/
+/*  span_scope.h                                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef SPAN_SCOPE_H
+#define SPAN_SCOPE_H
+
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/variant/string.hpp>
+
+#include "span_context.h"
+
+namespace godot {
+
+// The spans made current on the calling thread with activate(), innermost
+// last. Reading the current span is a thread_local access, so spans can be
+// parented implicitly without passing handles through every call. Each
+// entry keeps the span's context too, for exemplars and engine log records
+// that cannot look the handle up from the thread they are produced on.
+class ActiveSpanStack {
+public:
+	static const size_t MAX_DEPTH = 64;
+
+	static void push(const String &p_span_uuid, const SpanContext &p_context = SpanContext());
+	static void pop();
+	// Removes the innermost activation of `p_span_uuid`, wherever it is, so
+	// scopes closed out of order do not pop someone else's span.
+	static void remove(const String &p_span_uuid);
+	// Empty when no span is active on this thread.
+	static const String &get_current();
+	// Null when no span is active on this thread or it is not recording.
+	static const SpanContext *get_current_context();
+};
+
+// Keeps a span current on the thread that created it until the scope is
+// closed or freed. Returned by OpenTelemetry.activate_scope().
+class OpenTelemetryScope : public RefCounted {
+	GDCLASS(OpenTelemetryScope, RefCounted);
+
+	String span_uuid;
+	bool open = false;
+
+protected:
+	static void _bind_methods();
+
+public:
+	void open_scope(const String &p_span_uuid, const SpanContext &p_context);
+	void close();
+	String get_span() const;
+
+	~OpenTelemetryScope();
+};
+
+} // namespace godot
+
+#endif // SPAN_SCOPE_H
@@ -0,0 +1,155 @@
+/**************************************************************************/
+/*  tail_sampler.cpp                                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "tail_sampler.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace godot;
+
+const char *TailSampler::KEPT_SPANS_FILTER = " WHERE trace_id IN (SELECT trace_id FROM tail_sampling_decisions WHERE keep)";
+const char *TailSampler::ATTRIBUTE_MATCH_FUNCTION = "otel_has_attribute";
+
+namespace {
+
+// SQL wrapper around TailSampler::has_attribute().
+bool has_attribute_udf(duckdb::string_t p_attributes, duckdb::string_t p_fragment) {
+	return TailSampler::has_attribute(p_attributes.GetData(), p_attributes.GetSize(), p_fragment.GetData(), p_fragment.GetSize());
+}
+
+} // namespace
+
+bool TailSampler::has_attribute(const char *p_json, size_t p_size, const char *p_fragment, size_t p_fragment_size) {
+	int depth = 0;
+	bool in_string = false;
+	for (size_t i = 0; i < p_size; i++) {
+		char c = p_json[i];
+		if (in_string) {
+			if (c == '\\') {
+				i++;
+			} else if (c == '"') {
+				in_string = false;
+			}
+			continue;
+		}
+		if (c == '"') {
+			// Only keys of the top-level object start right after '{' or
+			// ',' at depth 1, and the value must end where the pair does.
+			if (depth == 1 && (p_json[i - 1] == '{' || p_json[i - 1] == ',') && p_size - i > p_fragment_size &&
+					std::memcmp(p_json + i, p_fragment, p_fragment_size) == 0 &&
+					(p_json[i + p_fragment_size] == ',' || p_json[i + p_fragment_size] == '}')) {
+				return true;
+			}
+			in_string = true;
+		} else if (c == '{' || c == '[') {
+			depth++;
+		} else if (c == '}' || c == ']') {
+			depth--;
+		}
+	}
+	return false;
+}
+
+std::string TailSampler::quote_literal(const std::string &p_string) {
+	std::string quoted = "'";
+	for (char c : p_string) {
+		if (c == '\'') {
+			quoted += '\'';
+		}
+		quoted += c;
+	}
+	quoted += '\'';
+	return quoted;
+}
+
+std::string TailSampler::build_keep_expression() const {
+	std::string expression = "bool_or(status = 2)";
+	if (policy.latency_threshold_ms > 0.0) {
+		uint64_t threshold_ns = (uint64_t)(policy.latency_threshold_ms * 1000000.0);
+		expression += " OR max(end_time_unix_nano - start_time_unix_nano) >= " + std::to_string(threshold_ns);
+	}
+	for (const std::string &match : policy.attribute_matches) {
+		expression += " OR bool_or(" + std::string(ATTRIBUTE_MATCH_FUNCTION) + "(attributes, " + quote_literal(match) + "))";
+	}
+	// Hashing the trace id keeps the probabilistic decision stable for
+	// spans that arrive after the trace was decided.
+	uint64_t keep_ppm = (uint64_t)(std::min(std::max(policy.keep_ratio, 0.0), 1.0) * 1000000.0);
+	expression += " OR hash(trace_id) % 1000000 < " + std::to_string(keep_ppm);
+	return expression;
+}
+
+void TailSampler::create_tables(duckdb::Connection &p_conn) {
+	p_conn.Query("CREATE TABLE tail_sampling_decisions ("
+				 "trace_id VARCHAR, "
+				 "keep BOOLEAN, "
+				 "decided_at BIGINT)");
+}
+
+void TailSampler::create_functions(duckdb::Connection &p_conn) {
+	p_conn.CreateScalarFunction<bool, duckdb::string_t, duckdb::string_t>(ATTRIBUTE_MATCH_FUNCTION, &has_attribute_udf);
+}
+
+void TailSampler::enable(const Policy &p_policy) {
+	policy = p_policy;
+	policy.decision_wait_ms = std::max(policy.decision_wait_ms, 0);
+	policy.max_hold_ms = std::max(policy.max_hold_ms, policy.decision_wait_ms);
+	enabled = true;
+}
+
+void TailSampler::disable() {
+	enabled = false;
+}
+
+void TailSampler::decide(duckdb::Connection &p_conn, uint64_t p_now_unix_nano, bool p_decide_all) {
+	uint64_t wait_ns = (uint64_t)policy.decision_wait_ms * 1000000ULL;
+	uint64_t hold_ns = (uint64_t)policy.max_hold_ms * 1000000ULL;
+	std::string quiet_cutoff = std::to_string(p_now_unix_nano > wait_ns ? p_now_unix_nano - wait_ns : 0);
+	std::string hold_cutoff = std::to_string(p_now_unix_nano > hold_ns ? p_now_unix_nano - hold_ns : 0);
+
+	// Forget decisions once late spans are no longer expected.
+	p_conn.Query("DELETE FROM tail_sampling_decisions WHERE decided_at < " + hold_cutoff);
+
+	// A trace is ready once no span ended within the decision wait, or when
+	// it has been held for max_hold_ms, which bounds the buffer for traces
+	// that never go quiet.
+	std::string query = "INSERT INTO tail_sampling_decisions "
+						"SELECT trace_id, " +
+			build_keep_expression() + ", " + std::to_string(p_now_unix_nano) +
+			" FROM spans"
+			" WHERE trace_id NOT IN (SELECT trace_id FROM tail_sampling_decisions)"
+			" GROUP BY trace_id";
+	if (!p_decide_all) {
+		query += " HAVING max(end_time_unix_nano) <= " + quiet_cutoff + " OR min(end_time_unix_nano) <= " + hold_cutoff;
+	}
+	p_conn.Query(query);
+
+	p_conn.Query("DELETE FROM spans WHERE trace_id IN (SELECT trace_id FROM tail_sampling_decisions WHERE NOT keep)");
+}
@@ -0,0 +1,95 @@
+/**************************************************************************/
+/*  tail_sampler.h                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TAIL_SAMPLER_H
+#define TAIL_SAMPLER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "duckdb.hpp"
+
+namespace godot {
+
+// Tail sampling over the buffered `spans` table. Once a trace has been
+// quiet for `decision_wait_ms` it is kept if any span has status ERROR,
+// exceeds the latency threshold or matches an attribute rule, and otherwise
+// with probability `keep_ratio`. Decisions are made per trace in one SQL
+// statement and remembered for a while, so late spans of a decided trace
+// follow the same decision. Callers serialize access with the database lock.
+class TailSampler {
+public:
+	static const int DEFAULT_DECISION_WAIT_MS = 5000;
+	static const int DEFAULT_MAX_HOLD_MS = 60000;
+	static const char *KEPT_SPANS_FILTER;
+	static const char *ATTRIBUTE_MATCH_FUNCTION;
+
+	struct Policy {
+		int decision_wait_ms = DEFAULT_DECISION_WAIT_MS;
+		int max_hold_ms = DEFAULT_MAX_HOLD_MS;
+		double latency_threshold_ms = 0.0; // 0 disables the latency rule.
+		double keep_ratio = 0.0;
+		// `"key":value` fragments serialized like the buffered span
+		// attributes (compact, sorted keys, full precision).
+		std::vector<std::string> attribute_matches;
+	};
+
+private:
+	bool enabled = false;
+	Policy policy;
+
+	static std::string quote_literal(const std::string &p_string);
+	std::string build_keep_expression() const;
+
+public:
+	static void create_tables(duckdb::Connection &p_conn);
+	// Registers ATTRIBUTE_MATCH_FUNCTION on the connection used by decide().
+	static void create_functions(duckdb::Connection &p_conn);
+
+	// True when the compact JSON object `p_json` has the top-level pair
+	// `p_fragment`. Pairs inside nested values or strings do not match,
+	// and the value must match whole, so `"level":1` does not match
+	// `"level":10`.
+	static bool has_attribute(const char *p_json, size_t p_size, const char *p_fragment, size_t p_fragment_size);
+
+	void enable(const Policy &p_policy);
+	void disable();
+	bool is_enabled() const { return enabled; }
+
+	// Decides every trace that is ready at `p_now_unix_nano`, or every
+	// buffered trace with `p_decide_all`, and deletes the spans of dropped
+	// traces. Kept spans are selected with KEPT_SPANS_FILTER.
+	void decide(duckdb::Connection &p_conn, uint64_t p_now_unix_nano, bool p_decide_all = false);
+};
+
+} // namespace godot
+
+#endif // TAIL_SAMPLER_H
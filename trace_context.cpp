@@ -0,0 +1,235 @@
+/**************************************************************************/
+/*  trace_context.cpp                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "trace_context.h"
+
+#include <cstring>
+
+using namespace godot;
+
+const char *TraceContextPropagator::TRACEPARENT_HEADER = "traceparent";
+const char *TraceContextPropagator::TRACESTATE_HEADER = "tracestate";
+
+// Offsets into `00-<trace id>-<parent id>-<flags>`.
+static const int TRACE_ID_OFFSET = 3;
+static const int SPAN_ID_OFFSET = 36;
+static const int FLAGS_OFFSET = 53;
+
+static int hex_value(char p_char) {
+	// Trace Context only allows lowercase hex digits.
+	if (p_char >= '0' && p_char <= '9') {
+		return p_char - '0';
+	}
+	if (p_char >= 'a' && p_char <= 'f') {
+		return p_char - 'a' + 10;
+	}
+	return -1;
+}
+
+// True if p_length characters at p_value are hex and not all zero.
+static bool is_valid_id(const char *p_value, int p_length) {
+	bool nonzero = false;
+	for (int i = 0; i < p_length; i++) {
+		int digit = hex_value(p_value[i]);
+		if (digit < 0) {
+			return false;
+		}
+		nonzero |= digit != 0;
+	}
+	return nonzero;
+}
+
+bool TraceContextPropagator::extract_traceparent(const char *p_value, size_t p_length, SpanContext &r_context) {
+	while (p_length > 0 && (*p_value == ' ' || *p_value == '\t')) {
+		p_value++;
+		p_length--;
+	}
+	while (p_length > 0 && (p_value[p_length - 1] == ' ' || p_value[p_length - 1] == '\t')) {
+		p_length--;
+	}
+	if (p_length < (size_t)TRACEPARENT_LENGTH) {
+		return false;
+	}
+
+	int version_high = hex_value(p_value[0]);
+	int version_low = hex_value(p_value[1]);
+	if (version_high < 0 || version_low < 0) {
+		return false;
+	}
+	int version = version_high * 16 + version_low;
+	if (version == 0xff) {
+		return false;
+	}
+	// Version 00 has an exact length; later versions may append fields.
+	if (version == 0 ? p_length != (size_t)TRACEPARENT_LENGTH : (p_length > (size_t)TRACEPARENT_LENGTH && p_value[TRACEPARENT_LENGTH] != '-')) {
+		return false;
+	}
+	if (p_value[2] != '-' || p_value[SPAN_ID_OFFSET - 1] != '-' || p_value[FLAGS_OFFSET - 1] != '-') {
+		return false;
+	}
+	if (!is_valid_id(p_value + TRACE_ID_OFFSET, TRACE_ID_LENGTH) || !is_valid_id(p_value + SPAN_ID_OFFSET, SPAN_ID_LENGTH)) {
+		return false;
+	}
+	int flags_high = hex_value(p_value[FLAGS_OFFSET]);
+	int flags_low = hex_value(p_value[FLAGS_OFFSET + 1]);
+	if (flags_high < 0 || flags_low < 0) {
+		return false;
+	}
+
+	r_context.trace_id.assign(p_value + TRACE_ID_OFFSET, TRACE_ID_LENGTH);
+	r_context.span_id.assign(p_value + SPAN_ID_OFFSET, SPAN_ID_LENGTH);
+	r_context.sampled = (flags_low & 0x1) != 0;
+	r_context.is_remote = true;
+	return true;
+}
+
+bool TraceContextPropagator::inject_traceparent(const SpanContext &p_context, char *r_buffer) {
+	std::string span_id = to_w3c_span_id(p_context.span_id);
+	if (p_context.trace_id.size() != (size_t)TRACE_ID_LENGTH || span_id.size() != (size_t)SPAN_ID_LENGTH) {
+		return false;
+	}
+	memcpy(r_buffer, "00-", 3);
+	memcpy(r_buffer + TRACE_ID_OFFSET, p_context.trace_id.data(), TRACE_ID_LENGTH);
+	r_buffer[SPAN_ID_OFFSET - 1] = '-';
+	memcpy(r_buffer + SPAN_ID_OFFSET, span_id.data(), SPAN_ID_LENGTH);
+	r_buffer[FLAGS_OFFSET - 1] = '-';
+	r_buffer[FLAGS_OFFSET] = '0';
+	r_buffer[FLAGS_OFFSET + 1] = p_context.sampled ? '1' : '0';
+	r_buffer[TRACEPARENT_LENGTH] = '\0';
+	return true;
+}
+
+std::string TraceContextPropagator::extract_trace_state(const char *p_value, size_t p_length) {
+	std::string trace_state;
+	int entries = 0;
+	size_t start = 0;
+	while (start <= p_length && entries < MAX_TRACE_STATE_ENTRIES) {
+		const char *comma = (const char *)memchr(p_value + start, ',', p_length - start);
+		size_t end = comma ? (size_t)(comma - p_value) : p_length;
+		size_t first = start;
+		size_t last = end;
+		while (first < last && (p_value[first] == ' ' || p_value[first] == '\t')) {
+			first++;
+		}
+		while (last > first && (p_value[last - 1] == ' ' || p_value[last - 1] == '\t')) {
+			last--;
+		}
+		if (last > first) {
+			if (!trace_state.empty()) {
+				trace_state += ',';
+			}
+			trace_state.append(p_value + first, last - first);
+			entries++;
+		}
+		start = end + 1;
+	}
+	return trace_state;
+}
+
+static const char HEX_DIGITS[] = "0123456789abcdef";
+
+// Binary layout: trace id, span id, flags.
+static const int BINARY_SPAN_ID_OFFSET = 16;
+static const int BINARY_FLAGS_OFFSET = 24;
+
+static bool decode_hex(const char *p_hex, int p_bytes, uint8_t *r_data) {
+	for (int i = 0; i < p_bytes; i++) {
+		int high = hex_value(p_hex[i * 2]);
+		int low = hex_value(p_hex[i * 2 + 1]);
+		if (high < 0 || low < 0) {
+			return false;
+		}
+		r_data[i] = (uint8_t)(high << 4 | low);
+	}
+	return true;
+}
+
+static void encode_hex(const uint8_t *p_data, int p_bytes, std::string &r_hex) {
+	r_hex.resize(p_bytes * 2);
+	for (int i = 0; i < p_bytes; i++) {
+		r_hex[i * 2] = HEX_DIGITS[p_data[i] >> 4];
+		r_hex[i * 2 + 1] = HEX_DIGITS[p_data[i] & 0xf];
+	}
+}
+
+static bool is_nonzero(const uint8_t *p_data, int p_bytes) {
+	for (int i = 0; i < p_bytes; i++) {
+		if (p_data[i] != 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool TraceContextPropagator::inject_binary(const SpanContext &p_context, uint8_t *r_buffer) {
+	std::string span_id = to_w3c_span_id(p_context.span_id);
+	if (p_context.trace_id.size() != (size_t)TRACE_ID_LENGTH || span_id.size() != (size_t)SPAN_ID_LENGTH) {
+		return false;
+	}
+	if (!decode_hex(p_context.trace_id.data(), TRACE_ID_LENGTH / 2, r_buffer) ||
+			!decode_hex(span_id.data(), SPAN_ID_LENGTH / 2, r_buffer + BINARY_SPAN_ID_OFFSET)) {
+		return false;
+	}
+	r_buffer[BINARY_FLAGS_OFFSET] = p_context.sampled ? 0x1 : 0x0;
+	return true;
+}
+
+bool TraceContextPropagator::extract_binary(const uint8_t *p_data, size_t p_length, SpanContext &r_context) {
+	if (p_length != (size_t)BINARY_LENGTH) {
+		return false;
+	}
+	if (!is_nonzero(p_data, TRACE_ID_LENGTH / 2) || !is_nonzero(p_data + BINARY_SPAN_ID_OFFSET, SPAN_ID_LENGTH / 2)) {
+		return false;
+	}
+	encode_hex(p_data, TRACE_ID_LENGTH / 2, r_context.trace_id);
+	encode_hex(p_data + BINARY_SPAN_ID_OFFSET, SPAN_ID_LENGTH / 2, r_context.span_id);
+	r_context.sampled = (p_data[BINARY_FLAGS_OFFSET] & 0x1) != 0;
+	r_context.is_remote = true;
+	return true;
+}
+
+std::string TraceContextPropagator::to_w3c_span_id(const std::string &p_span_id) {
+	if (p_span_id.size() == (size_t)SPAN_ID_LENGTH) {
+		return p_span_id;
+	}
+	char span_id[SPAN_ID_LENGTH];
+	int length = 0;
+	for (size_t i = p_span_id.size(); i > 0 && length < SPAN_ID_LENGTH; i--) {
+		char c = p_span_id[i - 1];
+		if (c != '-') {
+			span_id[SPAN_ID_LENGTH - 1 - length] = c;
+			length++;
+		}
+	}
+	if (length < SPAN_ID_LENGTH) {
+		return std::string();
+	}
+	return std::string(span_id, SPAN_ID_LENGTH);
+}
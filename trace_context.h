@@ -0,0 +1,77 @@
+/**************************************************************************/
+/*  trace_context.h                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TRACE_CONTEXT_H
+#define TRACE_CONTEXT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "span_context.h"
+
+namespace godot {
+
+// W3C Trace Context propagation (`traceparent` and `tracestate` headers).
+// The traceparent header has a fixed layout,
+// `vv-<32 hex trace id>-<16 hex parent id>-ff`, so it is validated and
+// decoded at fixed offsets without tokenizing or intermediate strings.
+//
+// For high-rate channels such as multiplayer RPCs the same context is also
+// available as 25 bytes: trace id (16), span id (8) and trace flags (1).
+// The tracestate is not part of the binary form.
+class TraceContextPropagator {
+public:
+	static const char *TRACEPARENT_HEADER;
+	static const char *TRACESTATE_HEADER;
+	static const int TRACEPARENT_LENGTH = 55;
+	static const int TRACE_ID_LENGTH = 32;
+	static const int SPAN_ID_LENGTH = 16;
+	static const int MAX_TRACE_STATE_ENTRIES = 32;
+	static const int BINARY_LENGTH = 25;
+
+	// Fills trace id, span id and sampled flag and marks the context as
+	// remote. Returns false for malformed or all-zero ids.
+	static bool extract_traceparent(const char *p_value, size_t p_length, SpanContext &r_context);
+	// Writes TRACEPARENT_LENGTH characters and a terminating NUL.
+	static bool inject_traceparent(const SpanContext &p_context, char *r_buffer);
+	// Trims the header and drops list members beyond the W3C limit.
+	static std::string extract_trace_state(const char *p_value, size_t p_length);
+	// Writes BINARY_LENGTH bytes.
+	static bool inject_binary(const SpanContext &p_context, uint8_t *r_buffer);
+	static bool extract_binary(const uint8_t *p_data, size_t p_length, SpanContext &r_context);
+	// Span handles are UUIDs; their low 64 bits become the W3C parent id.
+	// 16 digit hex ids from other processes are returned unchanged.
+	static std::string to_w3c_span_id(const std::string &p_span_id);
+};
+
+} // namespace godot
+
+#endif // TRACE_CONTEXT_H
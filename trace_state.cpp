@@ -0,0 +1,142 @@
+/**************************************************************************/
+/*  trace_state.cpp                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "trace_state.h"
+
+using namespace godot;
+
+const char *TraceState::OT_KEY = "ot";
+
+static std::string trim(const std::string &p_string) {
+	size_t start = p_string.find_first_not_of(" \t");
+	if (start == std::string::npos) {
+		return std::string();
+	}
+	size_t end = p_string.find_last_not_of(" \t");
+	return p_string.substr(start, end - start + 1);
+}
+
+bool TraceState::get_entry(const std::string &p_trace_state, const char *p_key, std::string &r_value) {
+	std::string key = p_key;
+	size_t pos = 0;
+	while (pos <= p_trace_state.size()) {
+		size_t end = p_trace_state.find(',', pos);
+		if (end == std::string::npos) {
+			end = p_trace_state.size();
+		}
+		std::string member = trim(p_trace_state.substr(pos, end - pos));
+		size_t equals = member.find('=');
+		if (equals != std::string::npos && member.compare(0, equals, key) == 0 && equals == key.size()) {
+			r_value = member.substr(equals + 1);
+			return true;
+		}
+		pos = end + 1;
+	}
+	return false;
+}
+
+std::string TraceState::set_entry(const std::string &p_trace_state, const char *p_key, const std::string &p_value) {
+	std::string key = p_key;
+	std::string result;
+	if (!p_value.empty()) {
+		result = key + "=" + p_value;
+	}
+	size_t pos = 0;
+	while (pos < p_trace_state.size()) {
+		size_t end = p_trace_state.find(',', pos);
+		if (end == std::string::npos) {
+			end = p_trace_state.size();
+		}
+		std::string member = trim(p_trace_state.substr(pos, end - pos));
+		size_t equals = member.find('=');
+		bool is_key = equals == key.size() && member.compare(0, equals, key) == 0;
+		if (!member.empty() && !is_key) {
+			if (!result.empty()) {
+				result += ',';
+			}
+			result += member;
+		}
+		pos = end + 1;
+	}
+	return result;
+}
+
+bool TraceState::get_ot_value(const std::string &p_trace_state, const char *p_key, std::string &r_value) {
+	std::string ot;
+	if (!get_entry(p_trace_state, OT_KEY, ot)) {
+		return false;
+	}
+	std::string key = p_key;
+	size_t pos = 0;
+	while (pos < ot.size()) {
+		size_t end = ot.find(';', pos);
+		if (end == std::string::npos) {
+			end = ot.size();
+		}
+		size_t colon = ot.find(':', pos);
+		if (colon != std::string::npos && colon < end && colon - pos == key.size() && ot.compare(pos, key.size(), key) == 0) {
+			r_value = ot.substr(colon + 1, end - colon - 1);
+			return true;
+		}
+		pos = end + 1;
+	}
+	return false;
+}
+
+std::string TraceState::set_ot_value(const std::string &p_trace_state, const char *p_key, const std::string &p_value) {
+	std::string ot;
+	get_entry(p_trace_state, OT_KEY, ot);
+
+	std::string key = p_key;
+	std::string updated;
+	size_t pos = 0;
+	while (pos < ot.size()) {
+		size_t end = ot.find(';', pos);
+		if (end == std::string::npos) {
+			end = ot.size();
+		}
+		size_t colon = ot.find(':', pos);
+		bool is_key = colon != std::string::npos && colon < end && colon - pos == key.size() && ot.compare(pos, key.size(), key) == 0;
+		if (end > pos && !is_key) {
+			if (!updated.empty()) {
+				updated += ';';
+			}
+			updated += ot.substr(pos, end - pos);
+		}
+		pos = end + 1;
+	}
+	if (!p_value.empty()) {
+		if (!updated.empty()) {
+			updated += ';';
+		}
+		updated += key + ":" + p_value;
+	}
+	return set_entry(p_trace_state, OT_KEY, updated);
+}
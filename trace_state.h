@@ -0,0 +1,56 @@
+/**************************************************************************/
+/*  trace_state.h                                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TRACE_STATE_H
+#define TRACE_STATE_H
+
+#include <string>
+
+namespace godot {
+
+// Helpers for the W3C `tracestate` header and the OpenTelemetry `ot` entry
+// in it, a `;` separated list of `key:value` pairs such as `ot=th:c;rv:...`.
+class TraceState {
+public:
+	static const char *OT_KEY;
+
+	static bool get_entry(const std::string &p_trace_state, const char *p_key, std::string &r_value);
+	// Moves the entry to the front, as required for modified entries, or
+	// removes it when `p_value` is empty.
+	static std::string set_entry(const std::string &p_trace_state, const char *p_key, const std::string &p_value);
+
+	static bool get_ot_value(const std::string &p_trace_state, const char *p_key, std::string &r_value);
+	// Updates one `ot` sub-key; an empty `p_value` erases it.
+	static std::string set_ot_value(const std::string &p_trace_state, const char *p_key, const std::string &p_value);
+};
+
+} // namespace godot
+
+#endif // TRACE_STATE_H